@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Run detection over contiguous integer columns, for the duplicate-reading scan of
+// 89_ch_11 Ex06.
+//
+// Ex06 finds each run with std::adjacent_find and walks it in a second loop, one
+// element and one branch at a time. Here one pass compares v[i..i+lanes) with
+// v[i+1..i+lanes+1) in a ymm register: the inverted compare mask has a bit per
+// run boundary, and tzcnt walks the bits, so runs cost one step per boundary
+// rather than per element. for_each_run streams the runs on the calling thread.
+// find_runs stores them and splits the column into one chunk per thread. A run
+// crossing a chunk edge shows up as the last run of one chunk and the first of the
+// next with the same value, and is joined when the chunks are stitched together.
+// The first and last run of a chunk are kept until then, because only the joined
+// length decides whether a run passes min_length.
+namespace runs {
+
+template <typename T>
+struct Run {
+  size_t start, length;
+  T value;
+  bool operator==(const Run &) const = default;
+};
+
+namespace detail {
+
+template <typename Fn>
+void for_chunks(size_t n, unsigned n_threads, Fn fn) {
+  if (n_threads <= 1) return fn(0u, size_t{0}, n);
+  vector<std::jthread> pool;
+  for (unsigned t = 0; t < n_threads; ++t)
+    pool.emplace_back(fn, t, n * t / n_threads, n * (t + 1) / n_threads);
+}
+
+inline unsigned threads_for(size_t n, unsigned n_threads) {
+  if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<unsigned>(std::clamp<size_t>(n, 1, n_threads));
+}
+
+#ifdef __AVX2__
+template <typename T>
+constexpr size_t lanes = 32 / sizeof(T);
+
+// one movemask bit per element: the lowest bit of its bytes
+template <typename T>
+constexpr uint32_t lane_bits = sizeof(T) == 1   ? 0xffffffffu
+                               : sizeof(T) == 2 ? 0x55555555u
+                               : sizeof(T) == 4 ? 0x11111111u
+                                                : 0x01010101u;
+
+// bit sizeof(T) * j set where p[j] == p[j + 1], for j in [0, lanes)
+template <typename T>
+inline uint32_t equal_bits(const T *p) {
+  const auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  const auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 1));
+  __m256i eq;
+  if constexpr (sizeof(T) == 1)
+    eq = _mm256_cmpeq_epi8(a, b);
+  else if constexpr (sizeof(T) == 2)
+    eq = _mm256_cmpeq_epi16(a, b);
+  else if constexpr (sizeof(T) == 4)
+    eq = _mm256_cmpeq_epi32(a, b);
+  else
+    eq = _mm256_cmpeq_epi64(a, b);
+  return static_cast<uint32_t>(_mm256_movemask_epi8(eq)) & lane_bits<T>;
+}
+#endif
+
+// fn(i) for every i in [lo, hi - 1) with v[i] != v[i + 1]
+template <typename T, typename Fn>
+void for_each_boundary(std::span<const T> v, size_t lo, size_t hi, Fn fn) {
+  size_t i = lo;
+#ifdef __AVX2__
+  for (; i + lanes<T> < hi; i += lanes<T>) {
+    for (auto m = ~equal_bits(v.data() + i) & lane_bits<T>; m; m &= m - 1)
+      fn(i + size_t(std::countr_zero(m)) / sizeof(T));
+  }
+#endif
+  for (; i + 1 < hi; ++i)
+    if (v[i] != v[i + 1]) fn(i);
+}
+
+// the runs of [lo, hi), keeping the first and last whatever their length
+template <typename T>
+void chunk_runs(std::span<const T> v, size_t lo, size_t hi, size_t min_length,
+                vector<Run<T>> &out) {
+  if (lo == hi) return;
+  size_t start = lo;
+  bool first = true;
+  for_each_boundary(v, lo, hi, [&](size_t i) {
+    const size_t length = i + 1 - start;
+    if (first || length >= min_length) out.push_back({start, length, v[i]});
+    first = false;
+    start = i + 1;
+  });
+  out.push_back({start, hi - start, v[hi - 1]});
+}
+
+}  // namespace detail
+
+// index of the first i with v[i] == v[i + 1], or v.size()
+template <std::integral T>
+size_t adjacent_find(std::span<const T> v) {
+  size_t i = 0;
+#ifdef __AVX2__
+  for (; i + detail::lanes<T> < v.size(); i += detail::lanes<T>)
+    if (auto m = detail::equal_bits(v.data() + i))
+      return i + size_t(std::countr_zero(m)) / sizeof(T);
+#endif
+  for (; i + 1 < v.size(); ++i)
+    if (v[i] == v[i + 1]) return i;
+  return v.size();
+}
+
+// fn(Run<T>) for every run of equal values at least min_length long, in order, on the
+// calling thread and without storing the runs
+template <std::integral T, typename Fn>
+void for_each_run(std::span<const T> v, size_t min_length, Fn fn) {
+  if (v.empty()) return;
+  size_t start = 0;
+  detail::for_each_boundary(v, 0, v.size(), [&](size_t i) {
+    if (i + 1 - start >= min_length) fn(Run<T>{start, i + 1 - start, v[i]});
+    start = i + 1;
+  });
+  if (v.size() - start >= min_length) fn(Run<T>{start, v.size() - start, v.back()});
+}
+
+// every run of equal values at least min_length long, in order
+template <std::integral T>
+vector<Run<T>> find_runs(std::span<const T> v, size_t min_length = 1,
+                         unsigned n_threads = 0) {
+  const auto n_t = detail::threads_for(v.size(), n_threads);
+  vector<vector<Run<T>>> parts(n_t);
+  detail::for_chunks(v.size(), n_t, [&](unsigned t, size_t lo, size_t hi) {
+    detail::chunk_runs(v, lo, hi, min_length, parts[t]);
+  });
+
+  // join runs across chunk edges, then drop the edge runs that stayed short
+  vector<Run<T>> out = std::move(parts[0]);
+  for (auto &part : parts | V::drop(1)) {
+    if (part.empty()) continue;
+    auto it = part.begin();
+    if (!out.empty() && out.back().value == it->value) {
+      out.back().length += it->length;
+      ++it;
+    }
+    out.insert(out.end(), it, part.end());
+    vector<Run<T>>().swap(part);
+  }
+  std::erase_if(out, [&](const Run<T> &r) { return r.length < min_length; });
+  return out;
+}
+
+}  // namespace runs
+
+int main() {
+  /************************************************************************************/
+  // 01_run_detect.cpp
+  {
+    const vector<int> temperatures = {72, 73, 75, 75, 76, 78, 78, 79, 80, 81};
+    const std::span<const int> temps = temperatures;
+
+    print("Ex01: first adjacent pair at {}\n", runs::adjacent_find(temps));
+    for (auto [start, length, value] : runs::find_runs(temps, 2))
+      print("Ex01: Found {} consecutive readings of value {} from index {}\n", length,
+            value, start);
+
+    auto all = runs::find_runs(temps);
+    print("Ex01: {} runs, 4 threads agree: {}\n", all.size(),
+          all == runs::find_runs(temps, 1, 4));
+
+    const vector<uint8_t> bytes = {7, 7, 7, 7, 7, 7, 7, 1, 1, 2, 7, 7, 7};
+    for (unsigned t : {1u, 3u, 5u})
+      print("Ex01: {} threads, runs of 3 or more: {}\n", t,
+            runs::find_runs(std::span<const uint8_t>(bytes), 3, t) |
+                V::transform([](auto r) { return std::pair{r.start, r.length}; }));
+  }
+
+  /************************************************************************************/
+  // 02_bench_run_detect.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      return elapsed.count();
+    };
+
+    // runs of 1..64 equal values; neighbouring runs may share a value and join
+    auto bench = [&]<typename T>(size_t N, T) {
+      vector<T> data(N);
+      std::mt19937_64 gen{2112};
+      for (size_t i = 0; i < N;) {
+        const auto r = gen();
+        const size_t len = std::min<size_t>(N - i, 1 + r % 64);
+        std::fill_n(data.begin() + i, len, static_cast<T>((r >> 8) % 16));
+        i += len;
+      }
+      const std::span<const T> v = data;
+
+      // 89_ch_11 Ex06: adjacent_find, then walk the run
+      size_t std_runs = 0, std_points = 0, std_hash = 0;
+      const auto t_std = time([&] {
+        for (auto it = data.begin();
+             (it = std::adjacent_find(it, data.end())) != data.end();) {
+          const auto value = *it;
+          const auto start = it;
+          while (it != data.end() && *it == value) ++it;
+          ++std_runs;
+          std_points += size_t(it - start);
+          std_hash += size_t(start - data.begin()) * 31 + size_t(value);
+        }
+      });
+
+      size_t n_runs = 0, n_points = 0, run_hash = 0;
+      const auto t_each = time([&] {
+        runs::for_each_run(v, 2, [&](runs::Run<T> r) {
+          ++n_runs;
+          n_points += r.length;
+          run_hash += r.start * 31 + size_t(r.value);
+        });
+      });
+      auto same = [&] {
+        return n_runs == std_runs && n_points == std_points && run_hash == std_hash;
+      };
+      const bool ok_each = same();
+
+      vector<runs::Run<T>> found;
+      const auto t_find = time([&] { found = runs::find_runs(v, 2); });
+      n_runs = n_points = run_hash = 0;
+      for (auto &r : found) {
+        ++n_runs;
+        n_points += r.length;
+        run_hash += r.start * 31 + size_t(r.value);
+      }
+      print("Ex02: {} x {}B, {} runs >= 2: adjacent_find loop {:.4f}s for_each_run "
+            "{:.4f}s find_runs (stored) {:.4f}s ok {}\n",
+            N, sizeof(T), std_runs, t_std, t_each, t_find,
+            ok_each && same());
+      found = {};
+
+      // a single equal pair at the very end
+      for (size_t i = 0; i < N; ++i) data[i] = static_cast<T>(i % 101);
+      data[N - 1] = data[N - 2];
+      size_t at_std = 0, at_simd = 0;
+      const auto t_af_std = time([&] {
+        at_std = size_t(std::adjacent_find(data.begin(), data.end()) - data.begin());
+      });
+      const auto t_af_simd = time([&] { at_simd = runs::adjacent_find(v); });
+      print("Ex02: {} x {}B std::adjacent_find {:.4f}s runs::adjacent_find {:.4f}s "
+            "ok {}\n",
+            N, sizeof(T), t_af_std, t_af_simd, at_std == at_simd && at_std == N - 2);
+    };
+
+    bench(1'000'000'000, uint8_t{});
+    bench(250'000'000, int32_t{});
+  }
+}
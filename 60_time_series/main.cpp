@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <print>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// A columnar time series for the SensorData readings of 89_ch_11 Ex06.
+//
+// Timestamps and values live in separate columns. Timestamps are stored as
+// delta-of-delta zigzag varints, so readings taken at a steady rate cost one byte
+// each. They are cut into blocks of block_size points, and every block records its
+// first timestamp and byte offset, so a time lookup is a binary search over blocks
+// plus decoding at most one block. Values are run-length encoded as (value, end
+// index) pairs: finding runs of equal readings is a walk over the runs, and the
+// value at an index is a binary search over the run ends. Points must be appended
+// in time order.
+namespace tseries {
+
+using Clock = std::chrono::system_clock;
+using time_point = Clock::time_point;
+using duration = Clock::duration;
+
+namespace detail {
+
+inline uint64_t zigzag(int64_t v) { return (uint64_t(v) << 1) ^ uint64_t(v >> 63); }
+inline int64_t unzigzag(uint64_t u) { return int64_t(u >> 1) ^ -int64_t(u & 1); }
+
+inline void put_varint(vector<uint8_t> &out, uint64_t u) {
+  while (u >= 0x80) {
+    out.push_back(uint8_t(u) | 0x80);
+    u >>= 7;
+  }
+  out.push_back(uint8_t(u));
+}
+
+inline uint64_t get_varint(const uint8_t *&p) {
+  if (*p < 0x80) return *p++;
+  uint64_t u = *p & 0x7f;
+  for (int shift = 7; *p++ & 0x80; shift += 7) u |= uint64_t(*p & 0x7f) << shift;
+  return u;
+}
+
+}  // namespace detail
+
+template <typename T>
+struct Run {
+  size_t start, length;
+  T value;
+};
+
+template <typename T>
+struct Bucket {
+  time_point start;
+  size_t count;
+  T min, max;
+  double mean;
+};
+
+template <std::equality_comparable T>
+class Series {
+ public:
+  static constexpr size_t block_size = 1024;
+
+  void append(time_point tp, const T &v) {
+    const int64_t t = tp.time_since_epoch().count();
+    if (n && t < last_t) throw std::invalid_argument("tseries: time went backwards");
+    if (n % block_size == 0) {
+      blocks.push_back({t, deltas.size()});
+      last_delta = 0;
+    } else {
+      const int64_t delta = t - last_t;
+      detail::put_varint(deltas, detail::zigzag(delta - last_delta));
+      last_delta = delta;
+    }
+    last_t = t;
+    if (run_values.empty() || !(run_values.back() == v)) {
+      run_values.push_back(v);
+      run_ends.push_back(n + 1);
+    } else {
+      ++run_ends.back();
+    }
+    ++n;
+  }
+
+  size_t size() const { return n; }
+  bool empty() const { return n == 0; }
+  size_t runs() const { return run_values.size(); }
+  size_t bytes() const {
+    return deltas.size() + blocks.size() * sizeof(Block) +
+           runs() * (sizeof(T) + sizeof(size_t));
+  }
+
+  // index of the first point at or after tp
+  size_t lower_bound(time_point tp) const {
+    const int64_t t = tp.time_since_epoch().count();
+    // the last block starting before t holds the answer, or it is the next block's
+    // first point
+    auto it = R::lower_bound(blocks, t, {}, &Block::first);
+    if (it == blocks.begin()) return 0;
+    const size_t b = size_t(it - blocks.begin()) - 1;
+    size_t found = std::min(n, (b + 1) * block_size);
+    walk_block(b, 0, [&](size_t i, int64_t ti) {
+      if (ti < t) return true;
+      found = i;
+      return false;
+    });
+    return found;
+  }
+
+  time_point time_at(size_t i) const {
+    int64_t t = 0;
+    walk_block(i / block_size, i % block_size, [&](size_t, int64_t ti) {
+      t = ti;
+      return false;
+    });
+    return time_point(duration(t));
+  }
+  const T &value_at(size_t i) const { return run_values[run_of(i)]; }
+
+  // fn(time_point, const T &) for the points in [first, last)
+  template <typename Fn>
+  void for_each(size_t first, size_t last, Fn fn) const {
+    if (first >= last) return;
+    size_t r = run_of(first);
+    for (size_t b = first / block_size; first < last; ++b) {
+      const size_t stop = std::min(last, (b + 1) * block_size);
+      walk_block(b, first % block_size, [&](size_t i, int64_t t) {
+        if (i == run_ends[r]) ++r;
+        fn(time_point(duration(t)), run_values[r]);
+        return i + 1 < stop;
+      });
+      first = stop;
+    }
+  }
+
+  // fn(time_point, const T &) for the points in [t0, t1)
+  template <typename Fn>
+  void for_each_in(time_point t0, time_point t1, Fn fn) const {
+    for_each(lower_bound(t0), lower_bound(t1), fn);
+  }
+
+  // fn(Run<T>) for every run of equal values, in order
+  template <typename Fn>
+  void for_each_run(Fn fn) const {
+    for (size_t r = 0, start = 0; r < runs(); start = run_ends[r++])
+      fn(Run<T>{start, run_ends[r] - start, run_values[r]});
+  }
+
+  // min, max, mean and count of [t0, t1) in buckets of width starting at t0; empty
+  // buckets are left out
+  vector<Bucket<T>> downsample(time_point t0, time_point t1, duration width) const
+    requires std::is_arithmetic_v<T>
+  {
+    vector<Bucket<T>> out;
+    for_each_in(t0, t1, [&](time_point t, const T &v) {
+      const time_point start = t0 + (t - t0) / width * width;
+      if (out.empty() || out.back().start != start) out.push_back({start, 0, v, v, 0});
+      auto &b = out.back();
+      ++b.count;
+      b.min = std::min(b.min, v);
+      b.max = std::max(b.max, v);
+      b.mean += double(v);
+    });
+    for (auto &b : out) b.mean /= double(b.count);
+    return out;
+  }
+
+ private:
+  struct Block {
+    int64_t first;
+    size_t offset;
+  };
+
+  size_t run_of(size_t i) const {
+    return size_t(R::upper_bound(run_ends, i) - run_ends.begin());
+  }
+
+  // fn(i, ticks) for the points of block b from offset `from`, while fn returns true
+  template <typename Fn>
+  void walk_block(size_t b, size_t from, Fn fn) const {
+    const size_t base = b * block_size, end = std::min(n, base + block_size);
+    const uint8_t *p = deltas.data() + blocks[b].offset;
+    int64_t t = blocks[b].first, delta = 0;
+    for (size_t i = base;; ++i) {
+      if (i >= base + from && !fn(i, t)) return;
+      if (i + 1 == end) return;
+      delta += detail::unzigzag(detail::get_varint(p));
+      t += delta;
+    }
+  }
+
+  vector<Block> blocks;
+  vector<uint8_t> deltas;
+  vector<T> run_values;
+  vector<size_t> run_ends;  // one past each run's last index
+  int64_t last_t{0}, last_delta{0};
+  size_t n{0};
+};
+
+}  // namespace tseries
+
+int main() {
+  using std::chrono::hours, std::chrono::minutes, std::chrono::seconds;
+  using std::chrono::system_clock;
+
+  struct SensorData {
+    int temperature{0};
+    system_clock::time_point timestamp;
+  };
+
+  /************************************************************************************/
+  // 01_time_series.cpp
+  {
+    const auto now = std::chrono::floor<seconds>(system_clock::now());
+
+    tseries::Series<int> readings;
+    for (auto [t, h] : {std::pair{72, 10}, {73, 9}, {75, 8}, {75, 7}, {76, 6},
+                        {78, 5}, {78, 4}, {79, 3}, {80, 2}, {81, 1}})
+      readings.append(now - hours(h), t);
+    print("Ex01: {} readings in {} runs, {} bytes\n", readings.size(), readings.runs(),
+          readings.bytes());
+
+    readings.for_each_run([&](tseries::Run<int> run) {
+      if (run.length < 2) return;
+      print("Ex01: Found consecutive duplicate readings of value: {} "
+            "taken at the following times:\n",
+            run.value);
+      readings.for_each(run.start, run.start + run.length,
+                        [](auto t, int) { print("\t{:%Y-%m-%d %H:%M:%S}\n", t); });
+    });
+
+    print("Ex01: last 4 hours:\n");
+    readings.for_each_in(now - hours(4), now, [](auto t, int v) {
+      print("\t{:%Y-%m-%d %H:%M:%S}: {}\n", t, v);
+    });
+
+    for (auto &b : readings.downsample(now - hours(10), now, hours(3)))
+      print("Ex01: 3h from {:%H:%M}: n {} min {} max {} mean {:.2f}\n", b.start,
+            b.count, b.min, b.max, b.mean);
+  }
+
+  /************************************************************************************/
+  // 02_bench_time_series.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      return elapsed.count();
+    };
+
+    // one reading a second with occasional millisecond jitter, and a temperature that
+    // changes on about one reading in eight
+    const size_t N = 10'000'000;
+    vector<SensorData> data(N);
+    std::mt19937 gen{2112};
+    const auto t0 = std::chrono::floor<hours>(system_clock::now()) - seconds(N);
+    int temp = 70;
+    for (size_t i = 0; i < N; ++i) {
+      if (gen() % 8 == 0) temp = std::clamp(temp + int(gen() % 3) - 1, 50, 90);
+      const auto jitter = gen() % 16 == 0 ? std::chrono::milliseconds(gen() % 50)
+                                          : std::chrono::milliseconds(0);
+      data[i] = {temp, t0 + seconds(i) + jitter};
+    }
+
+    std::list<SensorData> list;
+    tseries::Series<int> series;
+    const auto t_list = time([&] {
+      for (auto &d : data) list.push_back(d);
+    });
+    const auto t_series = time([&] {
+      for (auto &d : data) series.append(d.timestamp, d.temperature);
+    });
+    print("Ex02: ingest {} points    list {:.1f} M/s series {:.1f} M/s\n", N,
+          double(N) / t_list / 1e6, double(N) / t_series / 1e6);
+    print("Ex02: bytes per point     list >= {} (node without allocator overhead)"
+          " series {:.3f} ({} runs)\n",
+          2 * sizeof(void *) + sizeof(SensorData), double(series.bytes()) / double(N),
+          series.runs());
+
+    // consecutive duplicates, as in 89_ch_11 Ex06
+    size_t list_runs = 0, list_points = 0, series_runs = 0, series_points = 0;
+    const auto t_dup_list = time([&] {
+      auto is_eq = [](const SensorData &a, const SensorData &b) {
+        return a.temperature == b.temperature;
+      };
+      for (auto it = list.begin();
+           (it = std::adjacent_find(it, list.end(), is_eq)) != list.end();) {
+        const int value = it->temperature;
+        ++list_runs;
+        for (; it != list.end() && it->temperature == value; ++it) ++list_points;
+      }
+    });
+    const auto t_dup_series = time([&] {
+      series.for_each_run([&](tseries::Run<int> run) {
+        if (run.length < 2) return;
+        ++series_runs;
+        series_points += run.length;
+      });
+    });
+    print("Ex02: duplicate runs      list {:.4f}s series {:.6f}s ok {}\n", t_dup_list,
+          t_dup_series, list_runs == series_runs && list_points == series_points);
+
+    // mean temperature over one hour windows
+    auto window_start = [&](size_t q) {
+      return t0 + seconds(q * 1'000'003 % (N - 3600));
+    };
+    const size_t list_queries = 10, series_queries = 10'000;
+    bool ok = true;
+    auto list_mean = [&](system_clock::time_point a, system_clock::time_point b) {
+      auto it = R::find_if(list, [&](auto &d) { return d.timestamp >= a; });
+      int64_t sum = 0, count = 0;
+      for (; it != list.end() && it->timestamp < b; ++it, ++count)
+        sum += it->temperature;
+      return double(sum) / double(count);
+    };
+    auto series_mean = [&](system_clock::time_point a, system_clock::time_point b) {
+      int64_t sum = 0, count = 0;
+      series.for_each_in(a, b, [&](auto, int v) {
+        sum += v;
+        ++count;
+      });
+      return double(sum) / double(count);
+    };
+    vector<double> expected(list_queries);
+    const auto t_q_list = time([&] {
+      for (size_t q = 0; q < list_queries; ++q)
+        expected[q] = list_mean(window_start(q), window_start(q) + hours(1));
+    });
+    double checksum = 0;
+    const auto t_q_series = time([&] {
+      for (size_t q = 0; q < series_queries; ++q) {
+        const double m = series_mean(window_start(q), window_start(q) + hours(1));
+        if (q < list_queries) ok = ok && m == expected[q];
+        checksum += m;
+      }
+    });
+    print("Ex02: 1h range query      list {:.1f} us series {:.1f} us ok {} ({:.0f})\n",
+          t_q_list / double(list_queries) * 1e6,
+          t_q_series / double(series_queries) * 1e6, ok, checksum);
+
+    // one minute buckets over everything
+    const auto t_end = data.back().timestamp + seconds(1);
+    vector<tseries::Bucket<int>> list_buckets;
+    const auto t_ds_list = time([&] {
+      for (auto &d : list) {
+        const auto start = t0 + (d.timestamp - t0) / minutes(1) * minutes(1);
+        if (list_buckets.empty() || list_buckets.back().start != start)
+          list_buckets.push_back({start, 0, d.temperature, d.temperature, 0});
+        auto &b = list_buckets.back();
+        ++b.count;
+        b.min = std::min(b.min, d.temperature);
+        b.max = std::max(b.max, d.temperature);
+        b.mean += d.temperature;
+      }
+      for (auto &b : list_buckets) b.mean /= double(b.count);
+    });
+    vector<tseries::Bucket<int>> series_buckets;
+    const auto t_ds_series =
+        time([&] { series_buckets = series.downsample(t0, t_end, minutes(1)); });
+    auto same = [](auto &a, auto &b) {
+      return a.start == b.start && a.count == b.count && a.min == b.min &&
+             a.max == b.max && a.mean == b.mean;
+    };
+    print("Ex02: 1m downsample       list {:.4f}s series {:.4f}s ok {} ({} buckets)\n",
+          t_ds_list, t_ds_series, R::equal(list_buckets, series_buckets, same),
+          series_buckets.size());
+  }
+}
@@ -0,0 +1,418 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <new>
+#include <print>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Doubly linked list with the links inside pool-allocated nodes.
+//
+// Nodes come from a Pool: slabs of 64 KiB carved in order, with freed nodes kept on
+// an intrusive free list. Nodes created one after another are neighbours in memory,
+// so walking a freshly built list streams through a few slabs instead of chasing
+// allocations all over the heap, and freeing a node never calls the allocator.
+// The list itself is a ring through a sentinel hook, so splice and merge relink
+// nodes in O(1) each like std::list. sort() copies node pointers into a vector,
+// sorts that (by cached keys when T is a small trivially copyable type) and relinks
+// the nodes in one pass. Lists that exchange nodes must share a pool.
+namespace plist {
+
+struct Hook {
+  Hook *prev, *next;
+};
+
+template <typename T>
+struct Node : Hook {
+  T value;
+};
+
+template <typename T>
+class Pool {
+ public:
+  static constexpr size_t slab_bytes = 1 << 16;
+  static constexpr size_t per_slab =
+      std::max<size_t>(1, slab_bytes / sizeof(Node<T>));
+
+  Pool() = default;
+  Pool(const Pool &) = delete;
+  Pool &operator=(const Pool &) = delete;
+
+  template <typename... Args>
+  Node<T> *make(Args &&...args) {
+    void *p;
+    if (free_list) {
+      p = free_list;
+      free_list = free_list->next;
+    } else {
+      if (used == per_slab || slabs.empty()) {
+        slabs.push_back(std::make_unique_for_overwrite<Slot[]>(per_slab));
+        used = 0;
+      }
+      p = &slabs.back()[used++];
+    }
+    return ::new (p) Node<T>{{nullptr, nullptr}, T(std::forward<Args>(args)...)};
+  }
+
+  void release(Node<T> *n) {
+    n->~Node<T>();
+    free_list = ::new (static_cast<void *>(n)) Free{free_list};
+  }
+
+ private:
+  struct alignas(Node<T>) Slot {
+    std::byte bytes[sizeof(Node<T>)];
+  };
+  struct Free {
+    Free *next;
+  };
+  static_assert(sizeof(Free) <= sizeof(Slot));
+
+  vector<std::unique_ptr<Slot[]>> slabs;
+  size_t used{0};
+  Free *free_list{nullptr};
+};
+
+template <typename T>
+class List {
+  template <bool Const>
+  class Iter {
+   public:
+    using iterator_concept = std::bidirectional_iterator_tag;
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const T &, T &>;
+    using pointer = std::conditional_t<Const, const T *, T *>;
+
+    Iter() = default;
+    explicit Iter(Hook *h) : h(h) {}
+    template <bool C = Const>
+      requires C
+    Iter(const Iter<!C> &o) : h(o.hook()) {}
+
+    reference operator*() const { return static_cast<Node<T> *>(h)->value; }
+    pointer operator->() const { return &**this; }
+    Iter &operator++() {
+      h = h->next;
+      return *this;
+    }
+    Iter operator++(int) {
+      auto tmp = *this;
+      h = h->next;
+      return tmp;
+    }
+    Iter &operator--() {
+      h = h->prev;
+      return *this;
+    }
+    Iter operator--(int) {
+      auto tmp = *this;
+      h = h->prev;
+      return tmp;
+    }
+    bool operator==(const Iter &o) const { return h == o.h; }
+
+    Hook *hook() const { return h; }
+
+   private:
+    Hook *h{nullptr};
+  };
+
+ public:
+  using value_type = T;
+  using iterator = Iter<false>;
+  using const_iterator = Iter<true>;
+
+  explicit List(Pool<T> &pool) : pool(&pool) {}
+  List(Pool<T> &pool, std::initializer_list<T> init) : List(pool) {
+    for (auto &x : init) push_back(x);
+  }
+  List(const List &) = delete;
+  List &operator=(const List &) = delete;
+  ~List() { clear(); }
+
+  size_t size() const { return n; }
+  bool empty() const { return n == 0; }
+
+  iterator begin() { return iterator(root.next); }
+  iterator end() { return iterator(&root); }
+  const_iterator begin() const { return const_iterator(root.next); }
+  const_iterator end() const { return const_iterator(const_cast<Hook *>(&root)); }
+
+  T &front() { return *begin(); }
+  T &back() { return *--end(); }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args &&...args) {
+    auto *node = pool->make(std::forward<Args>(args)...);
+    link_before(pos.hook(), node);
+    ++n;
+    return iterator(node);
+  }
+  iterator insert(const_iterator pos, const T &x) { return emplace(pos, x); }
+  void push_back(const T &x) { emplace(end(), x); }
+  void push_front(const T &x) { emplace(begin(), x); }
+
+  iterator erase(const_iterator pos) {
+    auto *h = pos.hook();
+    auto *next = h->next;
+    unlink(h);
+    --n;
+    pool->release(static_cast<Node<T> *>(h));
+    return iterator(next);
+  }
+  void pop_front() { erase(begin()); }
+  void pop_back() { erase(--end()); }
+  void clear() {
+    while (n) pop_back();
+  }
+
+  // all of other before pos, in O(1)
+  void splice(const_iterator pos, List &other) {
+    check_pool(other);
+    if (other.empty()) return;
+    auto *first = other.root.next, *last = other.root.prev;
+    other.root.next = other.root.prev = &other.root;
+    auto *at = pos.hook();
+    first->prev = at->prev;
+    last->next = at;
+    at->prev->next = first;
+    at->prev = last;
+    n += std::exchange(other.n, 0);
+  }
+
+  // both sorted by comp; other's nodes are relinked into this list, other ends empty
+  template <typename Comp = std::less<>>
+  void merge(List &other, Comp comp = {}) {
+    check_pool(other);
+    if (&other == this) return;
+    Hook *a = root.next, *b = other.root.next, *tail = &root;
+    while (a != &root && b != &other.root) {
+      if (comp(value(b), value(a))) {
+        tail->next = b;
+        b->prev = tail;
+        tail = b;
+        b = b->next;
+      } else {
+        tail->next = a;
+        a->prev = tail;
+        tail = a;
+        a = a->next;
+      }
+    }
+    if (a != &root) {  // the rest of this list is still linked up to root
+      tail->next = a;
+      a->prev = tail;
+    } else if (b != &other.root) {  // append the rest of other
+      tail->next = b;
+      b->prev = tail;
+      other.root.prev->next = &root;
+      root.prev = other.root.prev;
+    } else {
+      tail->next = &root;
+      root.prev = tail;
+    }
+    other.root.next = other.root.prev = &other.root;
+    n += std::exchange(other.n, 0);
+  }
+
+  // stable
+  template <typename Comp = std::less<>>
+  void sort(Comp comp = {}) {
+    if (n < 2) return;
+    if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= 8) {
+      // sort keys next to their nodes, so comparisons never touch the nodes
+      vector<std::pair<T, Hook *>> keyed;
+      keyed.reserve(n);
+      for (auto *h = root.next; h != &root; h = h->next)
+        keyed.emplace_back(value(h), h);
+      std::stable_sort(keyed.begin(), keyed.end(), [&](const auto &x, const auto &y) {
+        return comp(x.first, y.first);
+      });
+      relink(keyed | V::values);
+    } else {
+      vector<Hook *> order;
+      order.reserve(n);
+      for (auto *h = root.next; h != &root; h = h->next) order.push_back(h);
+      std::stable_sort(order.begin(), order.end(),
+                       [&](Hook *x, Hook *y) { return comp(value(x), value(y)); });
+      relink(order);
+    }
+  }
+
+  template <typename Pred>
+  size_t remove_if(Pred pred) {
+    size_t removed = 0;
+    for (auto *h = root.next; h != &root;) {
+      auto *next = h->next;
+      if (pred(value(h))) {
+        unlink(h);
+        pool->release(static_cast<Node<T> *>(h));
+        ++removed;
+      }
+      h = next;
+    }
+    n -= removed;
+    return removed;
+  }
+
+ private:
+  static T &value(Hook *h) { return static_cast<Node<T> *>(h)->value; }
+
+  static void link_before(Hook *at, Hook *h) {
+    h->prev = at->prev;
+    h->next = at;
+    at->prev->next = h;
+    at->prev = h;
+  }
+  static void unlink(Hook *h) {
+    h->prev->next = h->next;
+    h->next->prev = h->prev;
+  }
+
+  void relink(R::input_range auto &&order) {
+    Hook *prev = &root;
+    for (Hook *h : order) {
+      prev->next = h;
+      h->prev = prev;
+      prev = h;
+    }
+    prev->next = &root;
+    root.prev = prev;
+  }
+
+  void check_pool(const List &other) const {
+    if (other.pool != pool)
+      throw std::invalid_argument("plist: lists use different pools");
+  }
+
+  Pool<T> *pool;
+  Hook root{&root, &root};
+  size_t n{0};
+};
+
+}  // namespace plist
+
+int main() {
+  /************************************************************************************/
+  // 01_pool_list.cpp
+  {
+    plist::Pool<int> pool;
+    plist::List<int> numbers(pool, {5, 1, 8, 3, 7});
+
+    print("Ex01 init: {}\n", numbers);
+    print("Ex01 reverse: {}\n", numbers | V::reverse);
+
+    auto at_8 = R::find(numbers, 8);
+    print("Ex01 from 8 till end: {}\n", R::subrange(at_8, numbers.end()));
+
+    numbers.insert(at_8, 2112);
+    print("Ex01 insert before 8: {}\n", numbers);
+
+    numbers.sort();
+    plist::List<int> more_numbers(pool, {2, 6, 4});
+    more_numbers.sort();
+    numbers.merge(more_numbers);
+    print("Ex01 after sort and merge: {}\n", numbers);
+
+    plist::List<int> additional_numbers(pool, {99, 100, 101});
+    numbers.splice(numbers.end(), additional_numbers);
+    print("Ex01 after splicing: {}\n", numbers);
+
+    numbers.remove_if([](int n) { return n % 2 == 0; });
+    print("Ex01 after removing even: {} (size {})\n", numbers, numbers.size());
+  }
+
+  /************************************************************************************/
+  // 02_bench_pool_list.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      return elapsed.count();
+    };
+    auto sum = [](const auto &l) {
+      int64_t s = 0;
+      for (auto x : l) s += x;
+      return s;
+    };
+    auto same = [](const auto &a, const auto &b) { return R::equal(a, b); };
+    auto row = [](std::string_view what, double t_std, double t_pool, bool ok) {
+      print("Ex02: {:<24} std::list {:.4f}s pool list {:.4f}s ok {}\n", what, t_std,
+            t_pool, ok);
+    };
+
+    const size_t N = 10'000'000;
+    vector<int> values(N);
+    std::mt19937 gen{2112};
+    for (auto &x : values) x = int(gen() % 1'000'000'000);
+
+    plist::Pool<int> pool;
+    std::list<int> sl;
+    plist::List<int> pl(pool);
+    const auto t_sb = time([&] {
+      for (auto x : values) sl.push_back(x);
+    });
+    const auto t_pb = time([&] {
+      for (auto x : values) pl.push_back(x);
+    });
+    row(std::format("push_back {} nodes", N), t_sb, t_pb, same(sl, pl));
+
+    int64_t s1 = 0, s2 = 0;
+    auto t_s = time([&] { s1 = sum(sl); }), t_p = time([&] { s2 = sum(pl); });
+    row("iterate, allocation order", t_s, t_p, s1 == s2);
+
+    t_s = time([&] { sl.sort(); });
+    t_p = time([&] { pl.sort(); });
+    row("sort", t_s, t_p, same(sl, pl));
+
+    t_s = time([&] { s1 = sum(sl); });
+    t_p = time([&] { s2 = sum(pl); });
+    row("iterate, sorted order", t_s, t_p, s1 == s2);
+
+    // merge with a second sorted list of N / 2
+    std::list<int> sl2;
+    plist::List<int> pl2(pool);
+    for (size_t i = 0; i < N / 2; ++i) {
+      const int x = int(gen() % 1'000'000'000);
+      sl2.push_back(x);
+      pl2.push_back(x);
+    }
+    sl2.sort();
+    pl2.sort();
+    t_s = time([&] { sl.merge(sl2); });
+    t_p = time([&] { pl.merge(pl2); });
+    row(std::format("merge {} + {}", N, N / 2), t_s, t_p,
+        same(sl, pl) && sl2.empty() && pl2.empty());
+
+    auto odd = [](int x) { return x % 2 != 0; };
+    size_t r1 = 0, r2 = 0;
+    t_s = time([&] { r1 = sl.remove_if(odd); });
+    t_p = time([&] { r2 = pl.remove_if(odd); });
+    row("remove_if odd", t_s, t_p, r1 == r2 && same(sl, pl));
+
+    t_s = time([&] { sl.clear(); });
+    t_p = time([&] { pl.clear(); });
+    row("clear", t_s, t_p, sl.empty() && pl.empty());
+  }
+}
@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <execution>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+using std::vector, std::print;
+
+// Double-ended queues whose storage is handed out as contiguous spans.
+//
+// RingDeque is one power-of-two array used as a ring: the element at index i lives at
+// (head + i) & mask, so indexing is an add and an and, and any window is at most two
+// spans. ChunkedDeque grows without bound in blocks of Block elements (a power of
+// two, chosen per type) kept in a ring of block pointers; index i is block
+// (off + i) >> log2(Block), slot (off + i) & (Block - 1), so a window of n is
+// n / Block + 2 spans at most. Kernels such as window_sum run over the spans with
+// plain vectorizable loops instead of stepping a deque iterator element by element.
+namespace deques {
+
+namespace detail {
+
+// random access iterator for containers with operator[]; T is const for const D
+template <typename D, typename T>
+class index_iterator {
+ public:
+  using iterator_concept = std::random_access_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_const_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using reference = T &;
+  using pointer = T *;
+
+  index_iterator() = default;
+  index_iterator(D *d, difference_type i) : d(d), i(i) {}
+
+  T &operator*() const { return (*d)[size_t(i)]; }
+  T &operator[](difference_type n) const { return (*d)[size_t(i + n)]; }
+
+  index_iterator &operator++() {
+    ++i;
+    return *this;
+  }
+  index_iterator operator++(int) {
+    auto tmp = *this;
+    ++i;
+    return tmp;
+  }
+  index_iterator &operator--() {
+    --i;
+    return *this;
+  }
+  index_iterator operator--(int) {
+    auto tmp = *this;
+    --i;
+    return tmp;
+  }
+  index_iterator &operator+=(difference_type n) {
+    i += n;
+    return *this;
+  }
+  index_iterator &operator-=(difference_type n) {
+    i -= n;
+    return *this;
+  }
+  friend index_iterator operator+(index_iterator it, difference_type n) {
+    return it += n;
+  }
+  friend index_iterator operator+(difference_type n, index_iterator it) {
+    return it += n;
+  }
+  friend index_iterator operator-(index_iterator it, difference_type n) {
+    return it -= n;
+  }
+  friend difference_type operator-(const index_iterator &a, const index_iterator &b) {
+    return a.i - b.i;
+  }
+  friend bool operator==(const index_iterator &a, const index_iterator &b) {
+    return a.i == b.i;
+  }
+  friend std::strong_ordering operator<=>(const index_iterator &a,
+                                          const index_iterator &b) {
+    return a.i <=> b.i;
+  }
+
+ private:
+  D *d{nullptr};
+  difference_type i{0};
+};
+
+}  // namespace detail
+
+// Fixed capacity (rounded up to a power of two); pushing onto a full deque throws
+// std::length_error.
+template <typename T>
+class RingDeque {
+ public:
+  using value_type = T;
+  using iterator = detail::index_iterator<RingDeque, T>;
+  using const_iterator = detail::index_iterator<const RingDeque, const T>;
+
+  explicit RingDeque(size_t capacity)
+      : mask(std::bit_ceil(std::max<size_t>(capacity, 1)) - 1),
+        buf(std::make_unique<T[]>(mask + 1)) {}
+
+  size_t size() const { return n; }
+  size_t capacity() const { return mask + 1; }
+  bool empty() const { return n == 0; }
+  bool full() const { return n == capacity(); }
+
+  T &operator[](size_t i) { return buf[(head + i) & mask]; }
+  const T &operator[](size_t i) const { return buf[(head + i) & mask]; }
+  T &front() { return (*this)[0]; }
+  T &back() { return (*this)[n - 1]; }
+
+  void push_back(const T &x) {
+    if (full()) throw std::length_error("RingDeque full");
+    buf[(head + n++) & mask] = x;
+  }
+  void push_front(const T &x) {
+    if (full()) throw std::length_error("RingDeque full");
+    head = (head - 1) & mask;
+    buf[head] = x;
+    ++n;
+  }
+  void pop_back() { --n; }
+  void pop_front() {
+    head = (head + 1) & mask;
+    --n;
+  }
+  void clear() { head = n = 0; }
+
+  // fn(std::span<T>) over [pos, pos + count) in order, at most twice; std::span<const
+  // T> on a const deque
+  template <typename Fn>
+  void for_each_segment(size_t pos, size_t count, Fn fn) {
+    segments<T>(pos, count, fn);
+  }
+  template <typename Fn>
+  void for_each_segment(size_t pos, size_t count, Fn fn) const {
+    segments<const T>(pos, count, fn);
+  }
+
+  iterator begin() { return {this, 0}; }
+  iterator end() { return {this, std::ptrdiff_t(n)}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, std::ptrdiff_t(n)}; }
+
+ private:
+  template <typename U, typename Fn>
+  void segments(size_t pos, size_t count, Fn &fn) const {
+    const auto start = (head + pos) & mask;
+    const auto first = std::min(count, capacity() - start);
+    fn(std::span<U>(buf.get() + start, first));
+    if (count > first) fn(std::span<U>(buf.get(), count - first));
+  }
+
+  size_t mask, head{0}, n{0};
+  std::unique_ptr<T[]> buf;
+};
+
+template <typename T, size_t Block = std::max<size_t>(16, 4096 / sizeof(T))>
+class ChunkedDeque {
+  static_assert(std::has_single_bit(Block), "Block must be a power of two");
+  static constexpr size_t shift = std::countr_zero(Block);
+
+ public:
+  using value_type = T;
+  using iterator = detail::index_iterator<ChunkedDeque, T>;
+  using const_iterator = detail::index_iterator<const ChunkedDeque, const T>;
+  static constexpr size_t block_size = Block;
+
+  size_t size() const { return n; }
+  bool empty() const { return n == 0; }
+
+  T &operator[](size_t i) {
+    const auto p = off + i;
+    return block(p >> shift)[p & (Block - 1)];
+  }
+  const T &operator[](size_t i) const {
+    const auto p = off + i;
+    return block(p >> shift)[p & (Block - 1)];
+  }
+  T &front() { return (*this)[0]; }
+  T &back() { return (*this)[n - 1]; }
+
+  void push_back(const T &x) {
+    const auto p = off + n;
+    if (p == blocks * Block) add_back();
+    block(p >> shift)[p & (Block - 1)] = x;
+    ++n;
+  }
+  void push_front(const T &x) {
+    if (off == 0) {
+      add_front();
+      off = Block;
+    }
+    block(0)[--off] = x;
+    ++n;
+  }
+  // a block is released as soon as its last element leaves; one is kept for reuse
+  void pop_back() {
+    --n;
+    if (off + n == (blocks - 1) * Block) drop_back();
+  }
+  void pop_front() {
+    --n;
+    if (++off == Block) {
+      drop_front();
+      off = 0;
+    }
+  }
+  void clear() {
+    while (blocks) drop_back();
+    off = n = 0;
+  }
+
+  // fn(std::span<T>) over [pos, pos + count) in order, one call per block touched;
+  // std::span<const T> on a const deque
+  template <typename Fn>
+  void for_each_segment(size_t pos, size_t count, Fn fn) {
+    segments<T>(pos, count, fn);
+  }
+  template <typename Fn>
+  void for_each_segment(size_t pos, size_t count, Fn fn) const {
+    segments<const T>(pos, count, fn);
+  }
+
+  iterator begin() { return {this, 0}; }
+  iterator end() { return {this, std::ptrdiff_t(n)}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, std::ptrdiff_t(n)}; }
+
+ private:
+  using Ptr = std::unique_ptr<T[]>;
+
+  T *block(size_t b) const { return map[(head + b) & map_mask].get(); }
+
+  template <typename U, typename Fn>
+  void segments(size_t pos, size_t count, Fn &fn) const {
+    for (auto p = off + pos; count;) {
+      const auto slot = p & (Block - 1);
+      const auto len = std::min(count, Block - slot);
+      fn(std::span<U>(block(p >> shift) + slot, len));
+      p += len;
+      count -= len;
+    }
+  }
+
+  Ptr new_block() {
+    if (spare) return std::move(spare);
+    return std::make_unique_for_overwrite<T[]>(Block);
+  }
+  void grow_map() {
+    vector<Ptr> bigger(std::max<size_t>(8, 2 * map.size()));
+    for (size_t b = 0; b < blocks; ++b)
+      bigger[b] = std::move(map[(head + b) & map_mask]);
+    map = std::move(bigger);
+    map_mask = map.size() - 1;
+    head = 0;
+  }
+  void add_back() {
+    if (blocks == map.size()) grow_map();
+    map[(head + blocks++) & map_mask] = new_block();
+  }
+  void add_front() {
+    if (blocks == map.size()) grow_map();
+    head = (head - 1) & map_mask;
+    map[head] = new_block();
+    ++blocks;
+  }
+  void drop_back() { spare = std::move(map[(head + --blocks) & map_mask]); }
+  void drop_front() {
+    spare = std::move(map[head]);
+    head = (head + 1) & map_mask;
+    --blocks;
+  }
+
+  vector<Ptr> map;  // ring of blocks, power-of-two size
+  size_t map_mask{0}, head{0}, blocks{0};
+  size_t off{0}, n{0};  // element 0 is slot off of the first block
+  Ptr spare;
+};
+
+// sum of [pos, pos + count), segment by segment
+template <typename D>
+auto window_sum(const D &d, size_t pos, size_t count) {
+  using T = typename D::value_type;
+  T acc{};
+  d.for_each_segment(pos, count, [&](std::span<const T> s) {
+    acc += std::reduce(std::execution::unseq, s.begin(), s.end(), T{});
+  });
+  return acc;
+}
+
+}  // namespace deques
+
+int main() {
+  /************************************************************************************/
+  // 01_chunked_deque.cpp
+  {
+    auto processInSlidingWindow = [](const auto &data, size_t windowSize) {
+      for (size_t i = 0; i + windowSize <= data.size(); ++i) {
+        auto sum = deques::window_sum(data, i, windowSize);
+        print("Ex01: Average of window starting at index {} : {}\n", i,
+              static_cast<double>(sum) / double(windowSize));
+      }
+    };
+
+    deques::ChunkedDeque<int, 4> numbers;  // tiny blocks so windows cross them
+    deques::RingDeque<int> ring(16);
+    for (int i = 1; i <= 5; ++i) {
+      numbers.push_back(i * 10);
+      numbers.push_front(-i * 10);
+      ring.push_back(i * 10);
+      ring.push_front(-i * 10);
+    }
+    print("Ex01: Numbers in deque: {}\n", numbers);
+
+    numbers.pop_front();
+    numbers.pop_back();
+    print("Ex01: After removing front and back: {}\n", numbers);
+
+    processInSlidingWindow(numbers, 3);
+
+    std::transform(numbers.begin(), numbers.end(), numbers.begin(),
+                   [](int n) { return n * 2; });
+    print("Ex01: After doubling each element: {}\n", numbers);
+
+    print("Ex01: ring segments of [2, 10):");
+    ring.for_each_segment(2, 8, [](std::span<int> s) { print(" {}", s); });
+    print("\n");
+  }
+
+  /************************************************************************************/
+  // 02_bench_chunked_deque.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      auto r = fn();
+      duration<double> elapsed = clock::now() - start;
+      return std::pair{r, elapsed.count()};
+    };
+
+    // queue of at most Q elements, M pushes at one end and pops at the other
+    const size_t M = 100'000'000, Q = 1000;
+    auto fifo = [&](auto &d) {
+      int64_t s = 0;
+      for (size_t i = 0; i < M; ++i) {
+        d.push_back(int(i));
+        if (d.size() > Q) {
+          s += d.front();
+          d.pop_front();
+        }
+      }
+      return s;
+    };
+    auto lifo_front = [&](auto &d) {
+      int64_t s = 0;
+      for (size_t i = 0; i < M; ++i) {
+        d.push_front(int(i));
+        if (d.size() > Q) {
+          s += d.back();
+          d.pop_back();
+        }
+      }
+      return s;
+    };
+    {
+      std::deque<int> a, c;
+      deques::RingDeque<int> b(Q + 1), e(Q + 1);
+      deques::ChunkedDeque<int> d, f;
+      auto [ra, ta] = time([&] { return fifo(a); });
+      auto [rb, tb] = time([&] { return fifo(b); });
+      auto [rd, td] = time([&] { return fifo(d); });
+      print("Ex02: {} push_back/pop_front  std::deque {:.4f}s ring {:.4f}s", M, ta, tb);
+      print(" chunked {:.4f}s ok {}\n", td, ra == rb && ra == rd);
+      auto [rc, tc] = time([&] { return lifo_front(c); });
+      auto [re, te] = time([&] { return lifo_front(e); });
+      auto [rf, tf] = time([&] { return lifo_front(f); });
+      print("Ex02: {} push_front/pop_back  std::deque {:.4f}s ring {:.4f}s", M, tc, te);
+      print(" chunked {:.4f}s ok {}\n", tf, rc == re && rc == rf);
+    }
+
+    // N elements, windowed sums: begin() + i iterator ranges against segment spans
+    const size_t N = 10'000'000;
+    std::deque<int> sd;
+    deques::RingDeque<int> rd(N);
+    deques::ChunkedDeque<int> cd;
+    std::mt19937 gen{2112};
+    for (size_t i = 0; i < N; ++i) {
+      const int x = int(gen() % 1000);
+      sd.push_back(x);
+      rd.push_back(x);
+      cd.push_back(x);
+    }
+
+    auto [ia, t_ia] = time([&] {
+      int64_t s = 0;
+      for (size_t i = 0; i < N; ++i) s += sd[i];
+      return s;
+    });
+    auto [ib, t_ib] = time([&] {
+      int64_t s = 0;
+      for (size_t i = 0; i < N; ++i) s += rd[i];
+      return s;
+    });
+    auto [ic, t_ic] = time([&] {
+      int64_t s = 0;
+      for (size_t i = 0; i < N; ++i) s += cd[i];
+      return s;
+    });
+    print("Ex02: {} operator[] reads      std::deque {:.4f}s ring {:.4f}s", N, t_ia,
+          t_ib);
+    print(" chunked {:.4f}s ok {}\n", t_ic, ia == ib && ia == ic);
+
+    for (size_t w : {16uz, 256uz, 4096uz}) {
+      // about 2e8 elements summed per container
+      const auto step = std::max<size_t>(1, N * w / 200'000'000);
+      auto [wa, t_wa] = time([&] {
+        int64_t s = 0;
+        for (size_t i = 0; i + w <= N; i += step)
+          s += std::reduce(sd.begin() + i, sd.begin() + i + w);
+        return s;
+      });
+      auto [wb, t_wb] = time([&] {
+        int64_t s = 0;
+        for (size_t i = 0; i + w <= N; i += step) s += deques::window_sum(rd, i, w);
+        return s;
+      });
+      auto [wc, t_wc] = time([&] {
+        int64_t s = 0;
+        for (size_t i = 0; i + w <= N; i += step) s += deques::window_sum(cd, i, w);
+        return s;
+      });
+      print("Ex02: window {:4} sums          std::deque {:.4f}s ring {:.4f}s", w, t_wa,
+            t_wb);
+      print(" chunked {:.4f}s ok {}\n", t_wc, wa == wb && wa == wc);
+    }
+  }
+}
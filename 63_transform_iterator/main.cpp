@@ -0,0 +1,273 @@
+#include <chrono>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// A random access view of fn(x) over contiguous memory, for SquareIterator of
+// 98_ch_02 Ex07.
+//
+// SquareIterator has no iterator_category, operator== or difference, so
+// std::iterator_traits knows nothing about it and no algorithm can split it.
+// transform_iterator is a complete random access iterator over a pointer: the
+// std::ranges concepts see random_access_iterator through iterator_concept, and
+// the classic algorithms (and their execution policy overloads, which split work by
+// iterator_category) see random_access_iterator_tag. The reference is a prvalue,
+// which the classic forward iterator requirements formally rule out; like
+// thrust::transform_iterator the tag is declared anyway, because every algorithm
+// that reads through *it works with a value.
+namespace xform {
+
+namespace detail {
+
+// Gives a copy-constructible callable (e.g. a capturing lambda) the assignment and
+// default construction an iterator needs.
+template <typename Fn>
+class box {
+ public:
+  box() = default;
+  explicit box(Fn f) : f(std::move(f)) {}
+  box(const box &) = default;
+  box &operator=(const box &o) {
+    if (this != &o) {
+      if (o.f)
+        f.emplace(*o.f);
+      else
+        f.reset();
+    }
+    return *this;
+  }
+
+  template <typename... Args>
+  decltype(auto) operator()(Args &&...args) const {
+    return (*f)(std::forward<Args>(args)...);
+  }
+
+ private:
+  std::optional<Fn> f;
+};
+
+template <typename Fn>
+using stored = std::conditional_t<std::semiregular<Fn>, Fn, box<Fn>>;
+
+}  // namespace detail
+
+template <typename T, typename Fn>
+  requires std::regular_invocable<const Fn &, const T &>
+class transform_iterator {
+ public:
+  using iterator_concept = std::random_access_iterator_tag;
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_cvref_t<std::invoke_result_t<const Fn &, const T &>>;
+  using difference_type = std::ptrdiff_t;
+  using reference = value_type;
+  using pointer = void;
+
+  transform_iterator() = default;
+  transform_iterator(const T *ptr, Fn fn) : ptr(ptr), fn(std::move(fn)) {}
+
+  const T *base() const { return ptr; }
+
+  value_type operator*() const { return std::invoke(fn, *ptr); }
+  value_type operator[](difference_type n) const { return std::invoke(fn, ptr[n]); }
+
+  transform_iterator &operator++() {
+    ++ptr;
+    return *this;
+  }
+  transform_iterator operator++(int) {
+    auto tmp = *this;
+    ++ptr;
+    return tmp;
+  }
+  transform_iterator &operator--() {
+    --ptr;
+    return *this;
+  }
+  transform_iterator operator--(int) {
+    auto tmp = *this;
+    --ptr;
+    return tmp;
+  }
+  transform_iterator &operator+=(difference_type n) {
+    ptr += n;
+    return *this;
+  }
+  transform_iterator &operator-=(difference_type n) {
+    ptr -= n;
+    return *this;
+  }
+
+  friend transform_iterator operator+(transform_iterator it, difference_type n) {
+    return it += n;
+  }
+  friend transform_iterator operator+(difference_type n, transform_iterator it) {
+    return it += n;
+  }
+  friend transform_iterator operator-(transform_iterator it, difference_type n) {
+    return it -= n;
+  }
+  friend difference_type operator-(const transform_iterator &a,
+                                   const transform_iterator &b) {
+    return a.ptr - b.ptr;
+  }
+  friend bool operator==(const transform_iterator &a, const transform_iterator &b) {
+    return a.ptr == b.ptr;
+  }
+  friend std::strong_ordering operator<=>(const transform_iterator &a,
+                                          const transform_iterator &b) {
+    return a.ptr <=> b.ptr;
+  }
+
+ private:
+  const T *ptr{nullptr};
+  [[no_unique_address]] detail::stored<Fn> fn{};
+};
+
+// fn over a span; random access, sized and common, with begin and end of one type
+template <typename T, typename Fn>
+class transform_view : public R::view_interface<transform_view<T, Fn>> {
+  using iterator = transform_iterator<T, detail::stored<Fn>>;
+
+ public:
+  transform_view() = default;
+  transform_view(std::span<const T> src, Fn fn) : src(src), fn(std::move(fn)) {}
+
+  iterator begin() const { return {src.data(), fn}; }
+  iterator end() const { return {src.data() + src.size(), fn}; }
+  size_t size() const { return src.size(); }
+
+ private:
+  std::span<const T> src;
+  [[no_unique_address]] detail::stored<Fn> fn{};
+};
+
+// The view keeps a span into rng, so rng must outlive it: temporaries that own
+// their elements are rejected, as with std::span.
+template <R::contiguous_range Rng, typename Fn>
+  requires R::borrowed_range<Rng>
+auto transform(Rng &&rng, Fn fn) {
+  using T = R::range_value_t<Rng>;
+  return transform_view<T, Fn>(std::span<const T>(R::data(rng), R::size(rng)),
+                               std::move(fn));
+}
+
+struct square {
+  template <typename T>
+  constexpr T operator()(const T &x) const {
+    return x * x;
+  }
+};
+
+template <R::contiguous_range Rng>
+  requires R::borrowed_range<Rng>
+auto squares(Rng &&rng) {
+  return transform(std::forward<Rng>(rng), square{});
+}
+
+static_assert(std::random_access_iterator<transform_iterator<int, square>>);
+static_assert(std::same_as<std::iterator_traits<transform_iterator<int, square>>::
+                               iterator_category,
+                           std::random_access_iterator_tag>);
+static_assert(R::random_access_range<transform_view<int, square>>);
+static_assert(R::sized_range<transform_view<int, square>>);
+static_assert(R::common_range<transform_view<int, square>>);
+static_assert(R::view<transform_view<int, square>>);
+
+template <typename Rng>
+concept squarable = requires(Rng &&rng) { squares(std::forward<Rng>(rng)); };
+static_assert(squarable<vector<int> &> && squarable<std::span<int>>);
+static_assert(!squarable<vector<int>>);  // would dangle
+
+}  // namespace xform
+
+int main() {
+  /************************************************************************************/
+  // 01_transform_iterator.cpp
+  {
+    std::vector<int> vec = {1, 2, 3, 4, 5};
+    auto sq = xform::squares(vec);
+
+    print("Ex01: {}\n", sq);
+    auto it = sq.begin() + 2;
+    print("Ex01: @ 2: {} @ 3: {} size {} end - it {}\n", *it, it[1], sq.size(),
+          sq.end() - it);
+    print("Ex01: reverse {}\n", sq | V::reverse);
+
+    const int offset = 10;  // capturing lambdas work too
+    auto shifted = xform::transform(vec, [offset](int x) { return x + offset; });
+    print("Ex01: shifted {} sum {}\n", shifted,
+          std::reduce(std::execution::par, shifted.begin(), shifted.end()));
+  }
+
+  /************************************************************************************/
+  // 02_bench_transform_iterator.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+    namespace exe = std::execution;
+
+    const size_t N = 100'000'000;
+    vector<int> data(N);
+    std::mt19937 gen{2112};
+    for (auto &x : data) x = int(gen() % 2001) - 1000;
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      auto r = fn();
+      duration<double> elapsed = clock::now() - start;
+      return std::pair{r, elapsed.count()};
+    };
+    const int64_t zero = 0;
+    const auto sq = xform::squares(data);
+
+    // materialized: squares written to a vector (allocated up front) and reduced
+    vector<int64_t> tmp(N);
+    auto row = [&](const char *name, auto policy) {
+      auto [m, t_m] = time([&] {
+        std::transform(policy, data.begin(), data.end(), tmp.begin(),
+                       [](int x) { return int64_t(x) * x; });
+        return std::reduce(policy, tmp.begin(), tmp.end(), zero);
+      });
+      auto [r, t_r] =
+          time([&] { return std::reduce(policy, tmp.begin(), tmp.end(), zero); });
+      auto [v, t_v] =
+          time([&] { return std::reduce(policy, sq.begin(), sq.end(), zero); });
+      auto [tr, t_tr] = time([&] {
+        return std::transform_reduce(policy, data.begin(), data.end(), zero,
+                                     std::plus{}, [](int x) { return int64_t(x) * x; });
+      });
+      print("Ex02: {:9} materialize+reduce {:.4f}s reduce only {:.4f}s", name, t_m,
+            t_r);
+      print(" squares view {:.4f}s transform_reduce {:.4f}s ok {}\n", t_v, t_tr,
+            m == r && m == v && m == tr);
+    };
+
+    // std::views::transform has an input_iterator_tag category (its reference is a
+    // value), so only the sequential overload accepts it
+    auto [s, t_std] = time([&] {
+      auto v = data | V::transform(xform::square{});
+      return std::reduce(v.begin(), v.end(), zero);
+    });
+    print("Ex02: N = {} views::transform + std::reduce {:.4f}s ({})\n", N, t_std, s);
+
+    row("seq", exe::seq);
+    row("unseq", exe::unseq);
+    row("par", exe::par);
+    row("par_unseq", exe::par_unseq);
+  }
+}
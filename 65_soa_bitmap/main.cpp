@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// RGBA images with one array per channel instead of one array of pixels.
+//
+// Bitmap (struct of arrays) keeps four 64 byte aligned planes, so a pass over alpha
+// reads only alpha bytes and every channel is a plain span a SIMD kernel can stream.
+// TiledBitmap (array of structs of arrays) keeps 32 pixels per tile as four 32 byte
+// rows, one ymm register each; a kernel that needs all four channels of a pixel
+// finds them two cache lines apart rather than four planes apart. Both hand out
+// proxy records (PixelRef) for code that wants pixels.
+namespace soa {
+
+struct RGBA {
+  uint8_t r, g, b, a;
+  bool operator==(const RGBA &) const = default;
+};
+
+// the four channels of one pixel, by reference; U is uint8_t or const uint8_t
+template <typename U>
+struct PixelRef {
+  U &r, &g, &b, &a;
+
+  operator RGBA() const { return {r, g, b, a}; }
+
+  const PixelRef &operator=(const RGBA &p) const
+    requires(!std::is_const_v<U>)
+  {
+    r = p.r, g = p.g, b = p.b, a = p.a;
+    return *this;
+  }
+  const PixelRef &operator=(const PixelRef &o) const
+    requires(!std::is_const_v<U>)
+  {
+    return *this = RGBA(o);
+  }
+};
+
+class Bitmap {
+ public:
+  Bitmap(size_t width, size_t height)
+      : w(width), h(height), stride((width * height + 63) / 64 * 64),
+        data(static_cast<uint8_t *>(std::aligned_alloc(64, 4 * stride))) {}
+
+  Bitmap(size_t width, size_t height, std::span<const RGBA> pixels)
+      : Bitmap(width, height) {
+    for (size_t i = 0; i < size(); ++i) (*this)[i] = pixels[i];
+  }
+
+  size_t width() const { return w; }
+  size_t height() const { return h; }
+  size_t size() const { return w * h; }
+
+  std::span<uint8_t> r() { return plane(0); }
+  std::span<uint8_t> g() { return plane(1); }
+  std::span<uint8_t> b() { return plane(2); }
+  std::span<uint8_t> a() { return plane(3); }
+  std::span<const uint8_t> a() const { return {data.get() + 3 * stride, size()}; }
+
+  PixelRef<uint8_t> operator[](size_t i) {
+    auto *p = data.get() + i;
+    return {p[0], p[stride], p[2 * stride], p[3 * stride]};
+  }
+  PixelRef<const uint8_t> operator[](size_t i) const {
+    const auto *p = data.get() + i;
+    return {p[0], p[stride], p[2 * stride], p[3 * stride]};
+  }
+
+  // random access range of PixelRef
+  auto pixels() {
+    return V::iota(0uz, size()) | V::transform([this](size_t i) { return (*this)[i]; });
+  }
+
+  void to_aos(std::span<RGBA> out) const {
+    for (size_t i = 0; i < size(); ++i) out[i] = (*this)[i];
+  }
+
+ private:
+  struct Free {
+    void operator()(uint8_t *p) const { std::free(p); }
+  };
+
+  std::span<uint8_t> plane(size_t c) { return {data.get() + c * stride, size()}; }
+
+  size_t w, h, stride;
+  std::unique_ptr<uint8_t[], Free> data;
+};
+
+class TiledBitmap {
+ public:
+  struct alignas(64) Tile {
+    static constexpr size_t lanes = 32;
+    uint8_t r[lanes], g[lanes], b[lanes], a[lanes];
+  };
+
+  TiledBitmap(size_t width, size_t height)
+      : w(width), h(height), data((width * height + Tile::lanes - 1) / Tile::lanes) {}
+
+  TiledBitmap(size_t width, size_t height, std::span<const RGBA> pixels)
+      : TiledBitmap(width, height) {
+    for (size_t i = 0; i < size(); ++i) (*this)[i] = pixels[i];
+  }
+
+  size_t width() const { return w; }
+  size_t height() const { return h; }
+  size_t size() const { return w * h; }
+
+  // the last tile is padded to full width; kernels may process the padding
+  std::span<Tile> tiles() { return data; }
+
+  PixelRef<uint8_t> operator[](size_t i) {
+    auto &t = data[i / Tile::lanes];
+    const auto l = i % Tile::lanes;
+    return {t.r[l], t.g[l], t.b[l], t.a[l]};
+  }
+  PixelRef<const uint8_t> operator[](size_t i) const {
+    const auto &t = data[i / Tile::lanes];
+    const auto l = i % Tile::lanes;
+    return {t.r[l], t.g[l], t.b[l], t.a[l]};
+  }
+
+  auto pixels() {
+    return V::iota(0uz, size()) | V::transform([this](size_t i) { return (*this)[i]; });
+  }
+
+  void to_aos(std::span<RGBA> out) const {
+    for (size_t i = 0; i < size(); ++i) out[i] = (*this)[i];
+  }
+
+ private:
+  size_t w, h;
+  vector<Tile> data;
+};
+
+namespace detail {
+
+// round(c * a / 255) without a division
+inline uint8_t mul255(unsigned c, unsigned a) {
+  const auto t = c * a + 128;
+  return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+inline void premultiply(uint8_t *r, uint8_t *g, uint8_t *b, const uint8_t *a,
+                        size_t n) {
+  size_t i = 0;
+#ifdef __AVX2__
+  const auto zero = _mm256_setzero_si256(), half = _mm256_set1_epi16(128);
+  // the same rounding on 16 bit lanes; c * a + 128 + (that >> 8) stays below 2^16
+  auto mul = [&](__m256i c, __m256i a16) {
+    const auto t = _mm256_add_epi16(_mm256_mullo_epi16(c, a16), half);
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+  };
+  for (; i + 32 <= n; i += 32) {
+    const auto av = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    const auto a_lo = _mm256_unpacklo_epi8(av, zero);
+    const auto a_hi = _mm256_unpackhi_epi8(av, zero);
+    for (auto *c : {r, g, b}) {
+      auto *p = reinterpret_cast<__m256i *>(c + i);
+      const auto cv = _mm256_loadu_si256(p);
+      const auto lo = mul(_mm256_unpacklo_epi8(cv, zero), a_lo);
+      const auto hi = mul(_mm256_unpackhi_epi8(cv, zero), a_hi);
+      _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    r[i] = mul255(r[i], a[i]);
+    g[i] = mul255(g[i], a[i]);
+    b[i] = mul255(b[i], a[i]);
+  }
+}
+
+inline void threshold(uint8_t *a, size_t n, uint8_t t) {
+  size_t i = 0;
+#ifdef __AVX2__
+  const auto tv = _mm256_set1_epi8(static_cast<char>(t));
+  for (; i + 32 <= n; i += 32) {
+    auto *p = reinterpret_cast<__m256i *>(a + i);
+    const auto v = _mm256_loadu_si256(p);
+    // v >= t exactly where max(v, t) == v
+    _mm256_storeu_si256(p, _mm256_cmpeq_epi8(_mm256_max_epu8(v, tv), v));
+  }
+#endif
+  for (; i < n; ++i) a[i] = a[i] >= t ? 255 : 0;
+}
+
+}  // namespace detail
+
+// r, g, b scaled by a / 255, rounded
+inline void premultiply(Bitmap &img) {
+  detail::premultiply(img.r().data(), img.g().data(), img.b().data(), img.a().data(),
+                      img.size());
+}
+inline void premultiply(TiledBitmap &img) {
+  for (auto &t : img.tiles()) detail::premultiply(t.r, t.g, t.b, t.a, t.lanes);
+}
+
+// alpha to 255 where it is >= t, else to 0; takes any plane, e.g. Bitmap::a()
+inline void threshold_alpha(std::span<uint8_t> a, uint8_t t) {
+  detail::threshold(a.data(), a.size(), t);
+}
+inline void threshold_alpha(TiledBitmap &img, uint8_t t) {
+  for (auto &tile : img.tiles()) detail::threshold(tile.a, tile.lanes, t);
+}
+
+}  // namespace soa
+
+// the strided path of 98_ch_02 Ex08, for comparison
+class AlphaIterator {
+ public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = uint8_t;
+  using difference_type = std::ptrdiff_t;
+  using pointer = uint8_t *;
+  using reference = uint8_t &;
+
+  explicit AlphaIterator(vector<soa::RGBA>::iterator itr) : itr_(itr) {}
+  AlphaIterator() = default;
+
+  reference operator*() { return itr_->a; }
+  AlphaIterator &operator++() {
+    ++itr_;
+    return *this;
+  }
+  AlphaIterator operator++(int) {
+    AlphaIterator tmp(*this);
+    ++itr_;
+    return tmp;
+  }
+  bool operator==(const AlphaIterator &other) const { return itr_ == other.itr_; }
+
+ private:
+  vector<soa::RGBA>::iterator itr_;
+};
+
+int main() {
+  /************************************************************************************/
+  // 01_soa_bitmap.cpp
+  {
+    using soa::RGBA;
+    const vector<RGBA> bitmap = {
+        {255, 0, 0, 128}, {0, 255, 0, 200}, {0, 0, 255, 255},
+        {255, 0, 0, 127}, {0, 255, 0, 201}, {0, 0, 255, 25},
+    };
+
+    soa::Bitmap img(3, 2, bitmap);
+    print("Ex01: Alpha plane before: {}\n", img.a());
+    for (auto &x : img.a()) ++x;
+    print("Ex01: Alpha plane after : {}\n", img.a());
+
+    img[0] = RGBA{10, 20, 30, 40};
+    for (auto px : img.pixels() | V::take(2)) {
+      const RGBA p = px;
+      print("Ex01: pixel {} {} {} {}\n", p.r, p.g, p.b, p.a);
+    }
+
+    soa::TiledBitmap tiled(3, 2, bitmap);
+    soa::premultiply(tiled);
+    soa::threshold_alpha(tiled, 128);
+    vector<RGBA> back(bitmap.size());
+    tiled.to_aos(back);
+    print("Ex01: premultiplied, thresholded:");
+    for (auto p : back) print(" ({} {} {} {})", p.r, p.g, p.b, p.a);
+    print("\n");
+  }
+
+  /************************************************************************************/
+  // 02_bench_soa_bitmap.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+    using soa::RGBA;
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      return elapsed.count() * 1e3;
+    };
+
+    std::mt19937 gen{2112};
+    const int reps = 5;
+    for (auto [w, h, name] :
+         {std::tuple{3840uz, 2160uz, "4K"}, std::tuple{7680uz, 4320uz, "8K"}}) {
+      vector<RGBA> aos(w * h);
+      for (auto &p : aos) {
+        const auto x = gen();
+        p = {uint8_t(x), uint8_t(x >> 8), uint8_t(x >> 16), uint8_t(x >> 24)};
+      }
+      soa::Bitmap img(w, h, aos);
+      soa::TiledBitmap tiled(w, h, aos);
+      vector<RGBA> out(aos.size()), out2(aos.size());
+
+      // alpha threshold: the only channel touched
+      const auto t_iter = time([&] {
+        for (int i = 0; i < reps; ++i)
+          std::for_each(AlphaIterator(aos.begin()), AlphaIterator(aos.end()),
+                        [](auto &x) { x = x >= 100 ? 255 : 0; });
+      });
+      const auto t_plane = time([&] {
+        for (int i = 0; i < reps; ++i) soa::threshold_alpha(img.a(), 100);
+      });
+      const auto t_tiles = time([&] {
+        for (int i = 0; i < reps; ++i) soa::threshold_alpha(tiled, 100);
+      });
+      img.to_aos(out);
+      tiled.to_aos(out2);
+      print("Ex02: {} threshold ms AlphaIterator {:7.2f} SoA {:6.2f} AoSoA {:6.2f}",
+            name, t_iter / reps, t_plane / reps, t_tiles / reps);
+      print(" ok {}\n", out == aos && out2 == aos);
+
+      // premultiply: every channel read, three written
+      const auto t_aos = time([&] {
+        for (int i = 0; i < reps; ++i)
+          for (auto &p : aos) {
+            p.r = soa::detail::mul255(p.r, p.a);
+            p.g = soa::detail::mul255(p.g, p.a);
+            p.b = soa::detail::mul255(p.b, p.a);
+          }
+      });
+      const auto t_soa = time([&] {
+        for (int i = 0; i < reps; ++i) soa::premultiply(img);
+      });
+      const auto t_aosoa = time([&] {
+        for (int i = 0; i < reps; ++i) soa::premultiply(tiled);
+      });
+      img.to_aos(out);
+      tiled.to_aos(out2);
+      print("Ex02: {} premultiply ms AoS loop {:7.2f} SoA {:6.2f} AoSoA {:6.2f}", name,
+            t_aos / reps, t_soa / reps, t_aosoa / reps);
+      print(" ok {}\n", out == aos && out2 == aos);
+    }
+  }
+}
@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <print>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+using std::vector, std::print, std::string;
+
+// Buffered, thread-friendly output to a file descriptor.
+//
+// Every thread formats into its own Writer with format_to_n, so formatting takes no
+// lock. Only a full buffer (buffer_bytes, 64 KiB by default) is handed to the Sink,
+// which writes it under one mutex (sync) or queues it for a flusher thread that
+// writes everything queued so far with one writev (async). Buffers always end on a
+// line a Writer printed, so lines of different threads never mix, and each thread's
+// lines stay in order. Emptied buffers are recycled, so the steady state does not
+// allocate.
+namespace sink {
+
+class Sink {
+ public:
+  enum class Mode { sync, async };
+
+  // Writers queue at most max_pending full buffers before they wait for the flusher.
+  static constexpr size_t max_pending = 64;
+  static constexpr size_t line_room = 4096;
+
+  explicit Sink(int fd = STDOUT_FILENO, Mode mode = Mode::async,
+                size_t buffer_bytes = 64 << 10)
+      : fd(fd), buffer_bytes(buffer_bytes) {
+    if (mode == Mode::async)
+      flusher = std::jthread([this](std::stop_token st) { flush_loop(st); });
+  }
+
+  // Writes everything queued. Writers must be gone (or flushed) by now.
+  ~Sink() {
+    if (flusher.joinable()) {
+      flusher.request_stop();
+      flusher.join();
+    }
+  }
+
+  Sink(const Sink &) = delete;
+  Sink &operator=(const Sink &) = delete;
+
+  // Per-thread formatting buffer; hands its lines to the Sink when the buffer is
+  // full, on flush() and on destruction.
+  class Writer {
+   public:
+    explicit Writer(Sink &s) : sink(&s), buf(s.take_buffer()) {}
+    Writer(Writer &&o) noexcept
+        : sink(std::exchange(o.sink, nullptr)), buf(std::move(o.buf)),
+          used(std::exchange(o.used, 0)) {}
+    Writer &operator=(Writer &&) = delete;
+    ~Writer() {
+      if (sink) flush();
+    }
+
+    // Formats straight into the free tail of the buffer; a line that does not fit
+    // grows the buffer and is formatted again.
+    template <typename... Args>
+    void print(std::format_string<const Args &...> fmt, const Args &...args) {
+      const auto room = buf.size() - used;
+      const auto r = std::format_to_n(buf.data() + used, room, fmt, args...);
+      const auto n = static_cast<size_t>(r.size);
+      if (n > room) {
+        buf.resize(used + n);
+        std::format_to_n(buf.data() + used, n, fmt, args...);
+      }
+      used += n;
+      if (used >= sink->buffer_bytes) flush();
+    }
+
+    void flush() {
+      if (!used) return;
+      buf.resize(std::exchange(used, 0));
+      sink->submit(buf);
+    }
+
+   private:
+    Sink *sink;
+    string buf;  // [0, used) is output, the rest is room
+    size_t used{0};
+  };
+
+  Writer writer() { return Writer(*this); }
+
+  // Waits until every buffer handed over so far is written; throws the first write
+  // error, if there was one.
+  void flush() {
+    std::unique_lock lk(m);
+    drained.wait(lk, [&] { return written == submitted; });
+    if (error) throw std::system_error(error, std::system_category(), "sink write");
+  }
+
+ private:
+  // a recycled or new buffer, sized to buffer_bytes plus room for one more line;
+  // m must be held
+  string spare_buffer() {
+    string s;
+    if (!spare.empty()) {
+      s = std::move(spare.back());
+      spare.pop_back();
+    }
+    s.resize(buffer_bytes + line_room);
+    return s;
+  }
+
+  string take_buffer() {
+    std::lock_guard lk(m);
+    return spare_buffer();
+  }
+
+  // writes or queues buf and leaves an empty buffer in its place
+  void submit(string &buf) {
+    if (!flusher.joinable()) {
+      std::lock_guard lk(m);
+      iovec iov{buf.data(), buf.size()};
+      write_all(std::span(&iov, 1));
+      buf.resize(buffer_bytes + line_room);
+      return;
+    }
+    std::unique_lock lk(m);
+    space.wait(lk, [&] { return queue.size() < max_pending; });
+    queue.push_back(std::move(buf));
+    ++submitted;
+    buf = spare_buffer();
+    lk.unlock();
+    ready.notify_one();
+  }
+
+  // Takes the whole queue at a time. Returns once stop is requested and the queue
+  // is empty.
+  void flush_loop(std::stop_token st) {
+    vector<string> batch;
+    vector<iovec> iov;
+    std::unique_lock lk(m);
+    while (ready.wait(lk, st, [&] { return !queue.empty(); })) {
+      batch.swap(queue);
+      lk.unlock();
+      space.notify_all();
+      iov.clear();
+      for (auto &b : batch) iov.push_back({b.data(), b.size()});
+      for (size_t i = 0; i < iov.size(); i += IOV_MAX)
+        write_all(std::span(iov).subspan(i, std::min<size_t>(IOV_MAX, iov.size() - i)));
+      lk.lock();
+      written += batch.size();
+      for (auto &b : batch) {
+        b.clear();
+        spare.push_back(std::move(b));
+      }
+      batch.clear();
+      drained.notify_all();
+    }
+  }
+
+  // writev until everything is out; remembers the first error and drops the rest
+  void write_all(std::span<iovec> iov) {
+    while (!iov.empty() && !error) {
+      const auto n = ::writev(fd, iov.data(), int(iov.size()));
+      if (n < 0) {
+        if (errno != EINTR) error = errno;
+        continue;
+      }
+      auto left = size_t(n);
+      while (!iov.empty() && left >= iov[0].iov_len) {
+        left -= iov[0].iov_len;
+        iov = iov.subspan(1);
+      }
+      if (left) {
+        iov[0].iov_base = static_cast<char *>(iov[0].iov_base) + left;
+        iov[0].iov_len -= left;
+      }
+    }
+  }
+
+  int fd;
+  size_t buffer_bytes;
+  std::mutex m;  // guards everything below, and the fd in sync mode
+  std::condition_variable_any ready, space, drained;
+  vector<string> queue, spare;
+  size_t submitted{0}, written{0};
+  int error{0};
+  std::jthread flusher;  // last: started after, and stopped before, the rest
+};
+
+}  // namespace sink
+
+int main() {
+  /************************************************************************************/
+  // 01_output_sink.cpp
+  {
+    std::fflush(stdout);  // the sink writes to the fd, below stdout's own buffer
+
+    sink::Sink out(STDOUT_FILENO, sink::Sink::Mode::sync);
+    {
+      auto w = out.writer();
+      for (int v = 0; v < 4; ++v) w.print("Ex01: dist[{}] = {}\n", v, v * v);
+    }
+
+    sink::Sink async_out;
+    {
+      vector<std::jthread> pool;
+      for (int t = 0; t < 3; ++t)
+        pool.emplace_back([&, t] {
+          auto w = async_out.writer();
+          w.print("Ex01: thread {} line 0\n", t);
+          w.print("Ex01: thread {} line 1\n", t);
+        });
+    }
+    async_out.flush();
+  }
+
+  /************************************************************************************/
+  // 02_bench_output_sink.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const size_t L = 4'000'000;  // lines per run, split over the threads
+
+    // line(t, lo, hi) prints lines [lo, hi) on thread t; done() drains the output
+    auto run = [&](size_t threads, auto line, auto done) {
+      auto start = clock::now();
+      {
+        vector<std::jthread> pool;
+        for (size_t t = 0; t < threads; ++t)
+          pool.emplace_back([&, t] {
+            const auto lo = L * t / threads, hi = L * (t + 1) / threads;
+            line(t, lo, hi);
+          });
+      }
+      done();
+      duration<double> elapsed = clock::now() - start;
+      return double(L) / elapsed.count() / 1e6;
+    };
+
+    // correctness: 4 threads through the async sink into a file, read back
+    {
+      char path[] = "/tmp/output_sink_XXXXXX";
+      const int fd = mkstemp(path);
+      {
+        sink::Sink s(fd);
+        run(
+            4,
+            [&](size_t t, size_t lo, size_t hi) {
+              auto w = s.writer();
+              for (auto i = lo; i < hi; ++i) w.print("{} {}\n", t, i);
+            },
+            [&] { s.flush(); });
+      }
+      auto *f = std::fopen(path, "r");
+      vector<size_t> next(4);
+      for (size_t t = 0; t < 4; ++t) next[t] = L * t / 4;
+      size_t lines = 0, t = 0, i = 0;
+      bool ok = true;
+      while (std::fscanf(f, "%zu %zu", &t, &i) == 2) {
+        ok &= t < 4 && next[t]++ == i;
+        ++lines;
+      }
+      std::fclose(f);
+      ::close(fd);
+      std::remove(path);
+      print("Ex02: {} lines from 4 threads through a file: in order {}\n", lines,
+            ok && lines == L);
+    }
+
+    // timings with fd 1 pointed at /dev/null, so std::print and cout keep their
+    // usual stdout locking
+    const int saved = ::dup(STDOUT_FILENO), null = ::open("/dev/null", O_WRONLY);
+    for (size_t threads : {1uz, 2uz, 4uz, 8uz}) {
+      std::fflush(stdout);
+      ::dup2(null, STDOUT_FILENO);
+      const auto t_print = run(
+          threads,
+          [](size_t t, size_t lo, size_t hi) {
+            for (auto i = lo; i < hi; ++i)
+              print("thread {} line {} value {}\n", t, i, i * 7);
+          },
+          [] { std::fflush(stdout); });
+      const auto t_cout = run(
+          threads,
+          [](size_t t, size_t lo, size_t hi) {
+            for (auto i = lo; i < hi; ++i)
+              std::cout << "thread " << t << " line " << i << " value " << i * 7
+                        << '\n';
+          },
+          [] { std::cout.flush(); });
+      double t_sink[2];
+      for (auto mode : {sink::Sink::Mode::sync, sink::Sink::Mode::async}) {
+        sink::Sink s(STDOUT_FILENO, mode);
+        t_sink[mode == sink::Sink::Mode::async] = run(
+            threads,
+            [&](size_t t, size_t lo, size_t hi) {
+              auto w = s.writer();
+              for (auto i = lo; i < hi; ++i)
+                w.print("thread {} line {} value {}\n", t, i, i * 7);
+            },
+            [&] { s.flush(); });
+      }
+      ::dup2(saved, STDOUT_FILENO);
+      print("Ex02: {} threads Mlines/s print {:6.2f} cout {:6.2f}", threads, t_print,
+            t_cout);
+      print(" sink sync {:6.2f} async {:6.2f}\n", t_sink[0], t_sink[1]);
+    }
+    ::close(null);
+    ::close(saved);
+  }
+}
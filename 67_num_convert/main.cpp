@@ -0,0 +1,363 @@
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using std::vector, std::print, std::string;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Number <-> text without allocation, exceptions or locale.
+//
+// Integers are written right to left two digits per division from a 200 byte table
+// of "00".."99", after the digit count has been found from the bit width, so the
+// output is never reversed. Floating point is std::to_chars (shortest round-trip)
+// and all variable-width parsing is std::from_chars. Zero-padded fields of up to 16
+// digits are parsed with SSE: one subtract, a shuffle that right-aligns the field,
+// and three multiply-adds that combine 2, 4 and 8 digits at a time.
+namespace numstr {
+
+// longest output of write() for T, sign included
+template <typename T>
+inline constexpr size_t max_chars = std::floating_point<T> ? 32 : 20;
+
+namespace detail {
+
+inline constexpr auto digit_pairs = [] {
+  std::array<char, 200> t{};
+  for (int i = 0; i < 100; ++i) {
+    t[2 * i] = char('0' + i / 10);
+    t[2 * i + 1] = char('0' + i % 10);
+  }
+  return t;
+}();
+
+inline constexpr auto pow10 = [] {
+  std::array<uint64_t, 20> t{};
+  for (uint64_t i = 0, p = 1; i < 20; ++i, p *= 10) t[i] = p;
+  return t;
+}();
+
+// decimal digits of v (1 for 0); bit_width * 1233 / 4096 is floor(log10(2^bits))
+inline size_t digits(uint64_t v) {
+  const auto t = static_cast<size_t>(std::bit_width(v | 1) * 1233 >> 12);
+  return t + ((v | 1) >= pow10[t]);
+}
+
+// the last n digits of v, zero-padded, into [p, p + n)
+inline void write_digits(char *p, uint64_t v, size_t n) {
+  for (; n >= 2; n -= 2, v /= 100)
+    std::memcpy(p + n - 2, &digit_pairs[2 * (v % 100)], 2);
+  if (n) *p = char('0' + v % 10);
+}
+
+#ifdef __AVX2__
+// right_align[w] moves the first w bytes to the end and zeroes the rest
+alignas(16) inline constexpr auto right_align = [] {
+  std::array<std::array<uint8_t, 16>, 17> t{};
+  for (size_t w = 0; w <= 16; ++w)
+    for (size_t j = 0; j < 16; ++j)
+      t[w][j] = j < 16 - w ? 0x80 : uint8_t(j - (16 - w));
+  return t;
+}();
+
+// the w digit field at p; 16 bytes at p must be readable
+inline std::optional<uint64_t> parse_fixed16(const char *p, size_t w) {
+  const auto raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  const auto shuffle =
+      _mm_load_si128(reinterpret_cast<const __m128i *>(right_align[w].data()));
+  const auto d = _mm_shuffle_epi8(_mm_sub_epi8(raw, _mm_set1_epi8('0')), shuffle);
+  const auto nine = _mm_set1_epi8(9);
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(d, nine), nine)) != 0xFFFF)
+    return std::nullopt;
+  const auto d2 = _mm_maddubs_epi16(d, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1,
+                                                     10, 1, 10, 1, 10, 1));
+  const auto d4 = _mm_madd_epi16(d2, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+  const auto d8 =
+      _mm_madd_epi16(_mm_packus_epi32(d4, d4),
+                     _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+  const auto hi = static_cast<uint32_t>(_mm_cvtsi128_si32(d8));
+  const auto lo = static_cast<uint32_t>(_mm_extract_epi32(d8, 1));
+  return uint64_t{hi} * 100'000'000 + lo;
+}
+#endif
+
+}  // namespace detail
+
+// Writes v at p and returns one past the last character. p must have room for
+// max_chars<T>. Values of up to 32 bits are divided as 32 bit.
+template <std::integral T>
+char *write(char *p, T v) {
+  using U = std::conditional_t<sizeof(T) <= 4, uint32_t, uint64_t>;
+  auto u = static_cast<U>(v);
+  if constexpr (std::signed_integral<T>)
+    if (v < 0) {
+      *p++ = '-';
+      u = 0 - u;
+    }
+  char *end = p + detail::digits(u), *q = end;
+  for (; u >= 100; u /= 100) {
+    q -= 2;
+    std::memcpy(q, &detail::digit_pairs[2 * (u % 100)], 2);
+  }
+  if (u >= 10)
+    std::memcpy(q - 2, &detail::digit_pairs[2 * u], 2);
+  else
+    q[-1] = char('0' + u);
+  return end;
+}
+
+template <std::floating_point T>
+char *write(char *p, T v) {
+  return std::to_chars(p, p + max_chars<T>, v).ptr;
+}
+
+template <typename T>
+string to_string(T v) {
+  string out;
+  out.resize_and_overwrite(max_chars<T>, [&](char *p, size_t) {
+    return static_cast<size_t>(write(p, v) - p);
+  });
+  return out;
+}
+
+// v zero-padded to exactly width digits; v must be below 10^width
+inline void write_fixed(char *p, uint64_t v, size_t width) {
+  detail::write_digits(p, v, width);
+}
+
+// The whole of s as a T; nullopt on any stray character, overflow or empty input.
+template <typename T>
+std::optional<T> parse(std::string_view s) {
+  T v{};
+  const auto end = s.data() + s.size();
+  const auto [p, ec] = std::from_chars(s.data(), end, v);
+  if (ec != std::errc{} || p != end) return std::nullopt;
+  return v;
+}
+
+// A field of digits only, as written by write_fixed.
+inline std::optional<uint64_t> parse_fixed(std::string_view field) {
+#ifdef __AVX2__
+  if (!field.empty() && field.size() <= 16) {
+    char buf[16]{};
+    std::memcpy(buf, field.data(), field.size());
+    return detail::parse_fixed16(buf, field.size());
+  }
+#endif
+  if (field.empty() || field.size() > 19) return std::nullopt;
+  return parse<uint64_t>(field);
+}
+
+// Batch APIs over whole columns. Outputs are preallocated by the caller.
+
+// Writes every value followed by sep and returns the bytes written. out must hold
+// in.size() * (max_chars<T> + 1) bytes.
+template <typename T>
+size_t format_column(std::span<const T> in, std::span<char> out, char sep = '\n') {
+  char *p = out.data();
+  for (auto v : in) {
+    p = write(p, v);
+    *p++ = sep;
+  }
+  return static_cast<size_t>(p - out.data());
+}
+
+// Records of stride bytes, each starting with a width digit field. out must hold
+// in.size() * stride bytes; the bytes after each field are left as they were.
+inline void format_fixed_column(std::span<const uint64_t> in, size_t width,
+                                size_t stride, std::span<char> out) {
+  for (size_t i = 0; i < in.size(); ++i)
+    write_fixed(out.data() + i * stride, in[i], width);
+}
+
+// Parses sep-terminated values into out and returns how many were read; stops at
+// the first malformed value or when out is full.
+template <typename T>
+size_t parse_column(std::string_view text, std::span<T> out, char sep = '\n') {
+  const char *p = text.data(), *end = p + text.size();
+  size_t i = 0;
+  for (; i < out.size() && p < end; ++i) {
+    const auto r = std::from_chars(p, end, out[i]);
+    if (r.ec != std::errc{} || (r.ptr != end && *r.ptr != sep)) break;
+    p = r.ptr + (r.ptr != end);  // skip sep; a last value may end at end
+  }
+  return i;
+}
+
+// The width digit field of every stride byte record of text into out, one per
+// record (the last one may end right after its field). Returns the number parsed
+// before the first malformed field.
+inline size_t parse_fixed_column(std::string_view text, size_t width, size_t stride,
+                                 std::span<uint64_t> out) {
+  if (text.size() < width) return 0;
+  const auto n = std::min(out.size(), (text.size() - width) / stride + 1);
+  size_t i = 0;
+#ifdef __AVX2__
+  // fields that are followed by at least 16 readable bytes are loaded in place
+  if (width <= 16)
+    for (; i < n && i * stride + 16 <= text.size(); ++i) {
+      const auto v = detail::parse_fixed16(text.data() + i * stride, width);
+      if (!v) return i;
+      out[i] = *v;
+    }
+#endif
+  for (; i < n; ++i) {
+    const auto v = parse_fixed(text.substr(i * stride, width));
+    if (!v) return i;
+    out[i] = *v;
+  }
+  return i;
+}
+
+}  // namespace numstr
+
+int main() {
+  /************************************************************************************/
+  // 01_num_convert.cpp
+  {
+    int number = 2112;
+    string numStr = numstr::to_string(number);
+    print("Ex01: number as string {}\n", numStr);
+    print("Ex01: string to num {}\n", numstr::parse<int>(numStr).value_or(-1));
+
+    print("Ex01: {} {} {}\n", numstr::to_string(-9'223'372'036'854'775'807 - 1),
+          numstr::to_string(0.1), numstr::to_string(uint64_t(-1)));
+    print("Ex01: parse \"12x\" {}, parse \"-0.25\" {}\n",
+          numstr::parse<int>("12x").has_value(),
+          numstr::parse<double>("-0.25").value());
+
+    char field[10];
+    numstr::write_fixed(field, 2112, sizeof field);
+    const std::string_view fixed(field, sizeof field);
+    print("Ex01: fixed {} -> {}\n", fixed, numstr::parse_fixed(fixed).value());
+
+    const vector<int> column = {7, -42, 2112, 0};
+    string text(column.size() * (numstr::max_chars<int> + 1), '\0');
+    text.resize(numstr::format_column<int>(column, text, ','));
+    vector<int> back(column.size());
+    print("Ex01: column \"{}\" parsed {}\n", text,
+          back | V::take(numstr::parse_column<int>(text, back, ',')));
+  }
+
+  /************************************************************************************/
+  // 02_bench_num_convert.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const size_t N = 10'000'000;
+    std::mt19937_64 gen{2112};
+    vector<int> ints(N);
+    for (auto &x : ints)
+      x = int(gen() % numstr::detail::pow10[1 + gen() % 9]) * (gen() & 1 ? 1 : -1);
+    vector<double> dbls(N);
+    std::uniform_real_distribution<double> unif(-1e6, 1e6);
+    for (auto &x : dbls) x = unif(gen);
+    vector<uint64_t> fixed(N);
+    for (auto &x : fixed) x = gen() % numstr::detail::pow10[16];
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      return double(N) / elapsed.count() / 1e6;
+    };
+
+    // int: to_string/stoi as in 94_ch_06 against to_chars/from_chars and numstr
+    {
+      vector<string> strs(N);
+      string buf(N * (numstr::max_chars<int> + 1), '\0');
+      size_t len_chars = 0, len_num = 0;
+      const auto t_to_string = time([&] {
+        for (size_t i = 0; i < N; ++i) strs[i] = std::to_string(ints[i]);
+      });
+      const auto t_to_chars = time([&] {
+        char *p = buf.data();
+        for (auto x : ints) {
+          p = std::to_chars(p, p + 11, x).ptr;
+          *p++ = '\n';
+        }
+        len_chars = size_t(p - buf.data());
+      });
+      const auto t_num =
+          time([&] { len_num = numstr::format_column<int>(ints, buf); });
+      print("Ex02: int    format M/s to_string {:7.1f} to_chars {:7.1f} numstr {:7.1f}",
+            t_to_string, t_to_chars, t_num);
+      print(" ok {}\n", len_chars == len_num);
+
+      const std::string_view text(buf.data(), len_num);
+      vector<int> a(N), b(N), c(N);
+      const auto t_stoi = time([&] {
+        for (size_t i = 0; i < N; ++i) a[i] = std::stoi(strs[i]);
+      });
+      const auto t_from_chars = time([&] {
+        const char *p = text.data(), *end = p + text.size();
+        for (auto &x : b) p = std::from_chars(p, end, x).ptr + 1;
+      });
+      size_t n = 0;
+      const auto t_parse = time([&] { n = numstr::parse_column<int>(text, c); });
+      print("Ex02: int    parse  M/s stoi      {:7.1f} from_chars {:5.1f}", t_stoi,
+            t_from_chars);
+      print(" numstr {:7.1f} ok {}\n", t_parse,
+            n == N && a == ints && b == ints && c == ints);
+    }
+
+    // double: to_string is "%f" and does not round-trip; to_chars is shortest exact
+    {
+      vector<string> strs(N);
+      string buf(N * (numstr::max_chars<double> + 1), '\0');
+      const auto t_to_string = time([&] {
+        for (size_t i = 0; i < N; ++i) strs[i] = std::to_string(dbls[i]);
+      });
+      size_t len = 0;
+      const auto t_num =
+          time([&] { len = numstr::format_column<double>(dbls, buf); });
+      print("Ex02: double format M/s to_string {:7.1f} numstr {:7.1f}\n", t_to_string,
+            t_num);
+
+      vector<double> a(N), b(N);
+      const auto t_stod = time([&] {
+        for (size_t i = 0; i < N; ++i) a[i] = std::stod(strs[i]);
+      });
+      size_t n = 0;
+      const auto t_parse = time([&] {
+        n = numstr::parse_column<double>(std::string_view(buf.data(), len), b);
+      });
+      print("Ex02: double parse  M/s stod      {:7.1f} numstr {:7.1f} round-trip {}\n",
+            t_stod, t_parse, n == N && b == dbls);
+    }
+
+    // 16 digit zero-padded fields, one per 17 byte line
+    {
+      const size_t W = 16, S = 17;
+      string buf(N * S, '\n');
+      const auto t_write = time([&] { numstr::format_fixed_column(fixed, W, S, buf); });
+      vector<uint64_t> a(N), b(N);
+      const auto t_from_chars = time([&] {
+        for (size_t i = 0; i < N; ++i)
+          std::from_chars(buf.data() + i * S, buf.data() + i * S + W, a[i]);
+      });
+      size_t n = 0;
+      const auto t_simd =
+          time([&] { n = numstr::parse_fixed_column(buf, W, S, b); });
+      print("Ex02: fixed16 M/s write {:7.1f} parse from_chars {:7.1f} simd {:7.1f}",
+            t_write, t_from_chars, t_simd);
+      print(" ok {}\n", n == N && a == fixed && b == fixed);
+    }
+  }
+}
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using std::vector, std::print, std::string;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Byte-at-a-time string transforms, 32 bytes per step with AVX2.
+//
+// Case conversion treats a 32 byte block as ASCII when no byte has the high bit
+// set: 'a'..'z' are found with two signed compares and flipped with one xor of
+// 0x20. Bytes with the high bit set are never in that range; they are found with a
+// movemask and go through std::toupper/tolower one by one, so single-byte locales
+// keep behaving as before.
+namespace ascii {
+
+namespace detail {
+
+template <bool Upper>
+void convert_scalar(char *p, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    const auto c = static_cast<unsigned char>(p[i]);
+    p[i] = static_cast<char>(Upper ? std::toupper(c) : std::tolower(c));
+  }
+}
+
+template <bool Upper>
+void convert(std::span<char> s) {
+  size_t i = 0;
+#ifdef __AVX2__
+  const auto first = _mm256_set1_epi8(Upper ? 'a' - 1 : 'A' - 1);
+  const auto last = _mm256_set1_epi8(Upper ? 'z' + 1 : 'Z' + 1);
+  const auto flip = _mm256_set1_epi8(0x20);
+  for (; i + 32 <= s.size(); i += 32) {
+    auto *p = reinterpret_cast<__m256i *>(s.data() + i);
+    const auto v = _mm256_loadu_si256(p);
+    const auto in_range =
+        _mm256_and_si256(_mm256_cmpgt_epi8(v, first), _mm256_cmpgt_epi8(last, v));
+    _mm256_storeu_si256(p, _mm256_xor_si256(v, _mm256_and_si256(in_range, flip)));
+    for (auto high = static_cast<uint32_t>(_mm256_movemask_epi8(v)); high;
+         high &= high - 1)
+      convert_scalar<Upper>(s.data() + i + std::countr_zero(high), 1);
+  }
+#endif
+  convert_scalar<Upper>(s.data() + i, s.size() - i);
+}
+
+#ifdef __AVX2__
+// keep_shuffle[m] moves the bytes of an 8 byte group whose bit in m is clear to
+// the front
+inline constexpr auto keep_shuffle = [] {
+  std::array<std::array<uint8_t, 8>, 256> t{};
+  for (unsigned m = 0; m < 256; ++m)
+    for (uint8_t b = 0, k = 0; b < 8; ++b)
+      if (!(m >> b & 1)) t[m][k++] = b;
+  return t;
+}();
+#endif
+
+}  // namespace detail
+
+inline void to_upper(std::span<char> s) { detail::convert<true>(s); }
+inline void to_lower(std::span<char> s) { detail::convert<false>(s); }
+inline void to_upper(string &s) { to_upper(std::span<char>(s)); }
+inline void to_lower(string &s) { to_lower(std::span<char>(s)); }
+
+// Removes every c in place and returns the new size. Each 32 byte block is compared
+// at once; a block without c is copied down whole, otherwise its four 8 byte groups
+// are compacted by one pshufb each through a 256 entry table.
+inline size_t remove(std::span<char> s, char c) {
+  size_t i = 0, k = 0;
+#ifdef __AVX2__
+  const auto needle = _mm256_set1_epi8(c);
+  for (; i + 32 <= s.size(); i += 32) {
+    const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s.data() + i));
+    const auto hits = static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+    if (hits == 0) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(s.data() + k), v);
+      k += 32;
+      continue;
+    }
+    alignas(32) char block[32];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(block), v);
+    for (size_t g = 0; g < 4; ++g) {
+      const auto m = (hits >> (8 * g)) & 0xFF;
+      uint64_t idx;
+      std::memcpy(&idx, detail::keep_shuffle[m].data(), 8);
+      const auto bytes =
+          _mm_loadl_epi64(reinterpret_cast<const __m128i *>(block + 8 * g));
+      const auto packed = _mm_shuffle_epi8(bytes, _mm_cvtsi64_si128(int64_t(idx)));
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(s.data() + k), packed);
+      k += 8 - static_cast<size_t>(std::popcount(m));
+    }
+  }
+#endif
+  for (; i < s.size(); ++i)
+    if (s[i] != c) s[k++] = s[i];
+  return k;
+}
+
+inline void remove(string &s, char c) { s.resize(remove(std::span<char>(s), c)); }
+
+// Index of the first byte of s that is in set, string_view::npos if none. Sets of
+// up to 8 bytes are matched with one compare per set byte per 32 byte block; larger
+// sets use a 256 entry table.
+inline size_t find_any_of(std::string_view s, std::string_view set) {
+  size_t i = 0;
+#ifdef __AVX2__
+  if (!set.empty() && set.size() <= 8) {
+    __m256i needles[8];
+    for (size_t j = 0; j < set.size(); ++j) needles[j] = _mm256_set1_epi8(set[j]);
+    for (; i + 32 <= s.size(); i += 32) {
+      const auto *p = reinterpret_cast<const __m256i *>(s.data() + i);
+      const auto v = _mm256_loadu_si256(p);
+      auto any = _mm256_cmpeq_epi8(v, needles[0]);
+      for (size_t j = 1; j < set.size(); ++j)
+        any = _mm256_or_si256(any, _mm256_cmpeq_epi8(v, needles[j]));
+      if (const auto m = static_cast<uint32_t>(_mm256_movemask_epi8(any)))
+        return i + static_cast<size_t>(std::countr_zero(m));
+    }
+  }
+#endif
+  std::array<bool, 256> in_set{};
+  for (auto c : set) in_set[static_cast<unsigned char>(c)] = true;
+  for (; i < s.size(); ++i)
+    if (in_set[static_cast<unsigned char>(s[i])]) return i;
+  return std::string_view::npos;
+}
+
+}  // namespace ascii
+
+int main() {
+  /************************************************************************************/
+  // 01_ascii_simd.cpp
+  {
+    string s = "Hello, C++ World! This line is long enough for a 32 byte block.";
+
+    string ups = s, lows = s;
+    ascii::to_upper(ups);
+    ascii::to_lower(lows);
+    print("Ex01: upcase: {}\n", ups);
+    print("Ex01: lowcase: {}\n", lows);
+
+    ascii::remove(s, ' ');
+    print("Ex01: erase spaces {}\n", s);
+    print("Ex01: first of \"+!\" at {}\n", ascii::find_any_of(s, "+!"));
+  }
+
+  /************************************************************************************/
+  // 02_bench_ascii_simd.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    // 256 MB of text: words of letters in both cases separated by spaces; the
+    // second variant has one byte in 64 above 0x7F
+    const size_t N = 256 << 20;
+    std::mt19937_64 gen{2112};
+    auto make_text = [&](bool latin1) {
+      string t(N, ' ');
+      for (auto &c : t) {
+        const auto r = gen() % 64;
+        if (r < 8) continue;
+        c = latin1 && r == 8 ? char(0xC0 + gen() % 32)
+                             : char((r & 1 ? 'a' : 'A') + gen() % 26);
+      }
+      return t;
+    };
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      return elapsed.count();
+    };
+    auto gbs = [&](double t) { return double(N) / t / 1e9; };
+
+    for (bool latin1 : {false, true}) {
+      const auto text = make_text(latin1);
+      print("Ex02: {} text\n", latin1 ? "1/64 non-ASCII" : "ASCII");
+
+      auto to_up = [](auto c) { return std::toupper(c); };
+      string ups, mine = text;
+      const auto t_view = time([&] {
+        ups = text | V::transform(to_up) | R::to<string>();
+      });
+      const auto t_up = time([&] { ascii::to_upper(mine); });
+      print("Ex02:   upper  views::transform {:6.2f} GB/s ascii {:6.2f} GB/s ok {}\n",
+            gbs(t_view), gbs(t_up), ups == mine);
+
+      auto to_low = [](auto c) { return std::tolower(c); };
+      string lows;
+      mine = text;
+      const auto t_lview = time([&] {
+        lows = text | V::transform(to_low) | R::to<string>();
+      });
+      const auto t_low = time([&] { ascii::to_lower(mine); });
+      print("Ex02:   lower  views::transform {:6.2f} GB/s ascii {:6.2f} GB/s ok {}\n",
+            gbs(t_lview), gbs(t_low), lows == mine);
+
+      string erased = text;
+      mine = text;
+      const auto t_erase = time([&] { std::erase(erased, ' '); });
+      const auto t_rm = time([&] { ascii::remove(mine, ' '); });
+      print("Ex02:   remove std::erase       {:6.2f} GB/s ascii {:6.2f} GB/s ok {}\n",
+            gbs(t_erase), gbs(t_rm), erased == mine);
+
+      // the only hit is in the last 64 bytes
+      mine = text;
+      mine[N - 40] = '!';
+      size_t a = 0, b = 0;
+      const auto t_ffo = time([&] { a = mine.find_first_of("!?;"); });
+      const auto t_any = time([&] { b = ascii::find_any_of(mine, "!?;"); });
+      print("Ex02:   find   find_first_of    {:6.2f} GB/s ascii {:6.2f} GB/s ok {}\n",
+            gbs(t_ffo), gbs(t_any), a == b && a == N - 40);
+    }
+  }
+}
@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <print>
+#include <random>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using std::vector, std::print, std::string;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// String assembly without the quadratic copy of fold_left(words, string(""), x + y).
+//
+// StringBuilder and join measure the total length first and then allocate the
+// result once, writing every byte exactly once. Rope is for text that keeps being
+// edited after it is built: a balanced tree of shared, immutable chunks where
+// concatenation, insertion and erasure cost O(log n) node copies rather than a
+// memmove of the whole string.
+namespace strings {
+
+// Collects pieces and concatenates them in one allocation on build(). Views are
+// stored as is, so what they point to must outlive build(); rvalue strings are
+// moved into the builder and owned by it.
+class StringBuilder {
+ public:
+  StringBuilder &operator<<(std::string_view s) {
+    pieces.push_back(s);
+    total += s.size();
+    return *this;
+  }
+  StringBuilder &operator<<(const char *s) { return *this << std::string_view(s); }
+  StringBuilder &operator<<(string &&s) {
+    return *this << std::string_view(owned.emplace_back(std::move(s)));
+  }
+
+  void reserve(size_t n_pieces) { pieces.reserve(n_pieces); }
+  size_t size() const { return total; }
+
+  string build() const {
+    string out;
+    out.resize_and_overwrite(total, [&](char *p, size_t) {
+      for (auto s : pieces) p = R::copy(s, p).out;
+      return total;
+    });
+    return out;
+  }
+
+ private:
+  vector<std::string_view> pieces;
+  std::deque<string> owned;  // deque: growing it never moves the strings
+  size_t total{0};
+};
+
+struct join_t {
+  std::string_view sep;
+};
+
+// range terminal: words | strings::join(", ")
+inline join_t join(std::string_view sep = {}) { return {sep}; }
+
+// Forward ranges are walked twice, once to measure and once to copy into a single
+// allocation. Single-pass ranges append as they go.
+template <R::input_range Rng>
+  requires std::convertible_to<R::range_reference_t<Rng>, std::string_view>
+string operator|(Rng &&rng, join_t j) {
+  string out;
+  if constexpr (R::forward_range<Rng>) {
+    size_t total = 0, count = 0;
+    for (auto &&x : rng) {
+      total += std::string_view(x).size();
+      ++count;
+    }
+    if (count > 1) total += (count - 1) * j.sep.size();
+    out.resize_and_overwrite(total, [&](char *p, size_t) {
+      bool first = true;
+      for (auto &&x : rng) {
+        if (!std::exchange(first, false)) p = R::copy(j.sep, p).out;
+        p = R::copy(std::string_view(x), p).out;
+      }
+      return total;
+    });
+  } else {
+    bool first = true;
+    for (auto &&x : rng) {
+      if (!std::exchange(first, false)) out += j.sep;
+      out += std::string_view(x);
+    }
+  }
+  return out;
+}
+
+// Persistent rope: an AVL-balanced binary tree whose leaves hold chunks of at most
+// max_leaf bytes. Nodes are immutable and shared, so copies are O(1) and every edit
+// rebuilds only the O(log n) nodes on the paths it touches. All edits come down to
+// split and join.
+class Rope {
+  struct Node;
+  using Ptr = std::shared_ptr<const Node>;
+  struct Node {
+    string leaf;  // only for leaves
+    Ptr left, right;
+    size_t size;
+    int height;
+  };
+
+ public:
+  static constexpr size_t max_leaf = 1024;
+
+  Rope() = default;
+  explicit Rope(std::string_view s) : root(build(s)) {}
+
+  size_t size() const { return root ? root->size : 0; }
+  bool empty() const { return size() == 0; }
+
+  char operator[](size_t i) const {
+    const Node *n = root.get();
+    while (n->left)
+      if (i < n->left->size) {
+        n = n->left.get();
+      } else {
+        i -= n->left->size;
+        n = n->right.get();
+      }
+    return n->leaf[i];
+  }
+
+  Rope &operator+=(const Rope &o) {
+    root = join(root, o.root);
+    return *this;
+  }
+  Rope &operator+=(std::string_view s) { return *this += Rope(s); }
+  friend Rope operator+(Rope a, const Rope &b) { return a += b; }
+
+  void insert(size_t pos, std::string_view s) {
+    auto [l, r] = split(root, pos);
+    root = join(join(l, build(s)), r);
+  }
+
+  void erase(size_t pos, size_t n) {
+    auto [l, rest] = split(root, pos);
+    root = join(l, split(rest, n).second);
+  }
+
+  Rope substr(size_t pos, size_t n) const {
+    Rope out;
+    out.root = split(split(root, pos).second, n).first;
+    return out;
+  }
+
+  // calls fn(string_view) for every chunk in order
+  template <typename Fn>
+  void for_each_chunk(Fn fn) const {
+    vector<const Node *> stack;
+    for (auto *n = root.get(); n || !stack.empty();) {
+      for (; n; n = n->left.get()) stack.push_back(n);
+      n = stack.back();
+      stack.pop_back();
+      if (!n->left) fn(std::string_view(n->leaf));
+      n = n->right.get();
+    }
+  }
+
+  string str() const {
+    string out;
+    out.resize_and_overwrite(size(), [&](char *p, size_t) {
+      for_each_chunk([&](std::string_view c) { p = R::copy(c, p).out; });
+      return size();
+    });
+    return out;
+  }
+
+ private:
+  static int height(const Ptr &n) { return n ? n->height : 0; }
+
+  static Ptr leaf(string s) {
+    const auto n = s.size();
+    return std::make_shared<const Node>(Node{std::move(s), nullptr, nullptr, n, 1});
+  }
+  static Ptr node(Ptr l, Ptr r) {
+    const auto s = l->size + r->size;
+    const auto h = 1 + std::max(l->height, r->height);
+    return std::make_shared<const Node>(Node{{}, std::move(l), std::move(r), s, h});
+  }
+
+  // perfectly balanced tree over s in chunks of max_leaf
+  static Ptr build(std::string_view s) {
+    if (s.empty()) return nullptr;
+    if (s.size() <= max_leaf) return leaf(string(s));
+    const auto chunks = (s.size() + max_leaf - 1) / max_leaf;
+    const auto mid = chunks / 2 * max_leaf;
+    return node(build(s.substr(0, mid)), build(s.substr(mid)));
+  }
+
+  // AVL rotations for a node whose children differ in height by 2
+  static Ptr balance(Ptr l, Ptr r) {
+    if (height(l) > height(r) + 1) {
+      if (height(l->left) >= height(l->right)) return node(l->left, node(l->right, r));
+      return node(node(l->left, l->right->left), node(l->right->right, r));
+    }
+    if (height(r) > height(l) + 1) {
+      if (height(r->right) >= height(r->left)) return node(node(l, r->left), r->right);
+      return node(node(l, r->left->left), node(r->left->right, r->right));
+    }
+    return node(std::move(l), std::move(r));
+  }
+
+  // concatenation: descend the taller side's spine to the other's height, so the
+  // result stays balanced. Two small leaves are merged so appends do not fragment.
+  static Ptr join(const Ptr &a, const Ptr &b) {
+    if (!a) return b;
+    if (!b) return a;
+    if (!a->left && !b->left && a->size + b->size <= max_leaf)
+      return leaf(a->leaf + b->leaf);
+    if (a->height > b->height + 1) return balance(a->left, join(a->right, b));
+    if (b->height > a->height + 1) return balance(join(a, b->left), b->right);
+    return node(a, b);
+  }
+
+  // [0, i) and [i, size)
+  static std::pair<Ptr, Ptr> split(const Ptr &n, size_t i) {
+    if (!n || i == 0) return {nullptr, n};
+    if (i >= n->size) return {n, nullptr};
+    if (!n->left) return {leaf(n->leaf.substr(0, i)), leaf(n->leaf.substr(i))};
+    if (i <= n->left->size) {
+      auto [l, r] = split(n->left, i);
+      return {l, join(r, n->right)};
+    }
+    auto [l, r] = split(n->right, i - n->left->size);
+    return {join(n->left, l), r};
+  }
+
+  Ptr root;
+};
+
+}  // namespace strings
+
+int main() {
+  /************************************************************************************/
+  // 01_string_builder.cpp
+  {
+    vector<string> words = {"Hello", ", ", "world", "!"};
+
+    strings::StringBuilder sb;
+    for (auto &w : words) sb << w;
+    sb << " Bye.";
+    print("Ex01: StringBuilder: {}\n", sb.build());
+
+    print("Ex01: join(): {}\n", words | strings::join());
+    print("Ex01: join(\"|\") over a transform: {}\n",
+          words | V::transform([](auto &w) { return "<" + w + ">"; }) |
+              strings::join("|"));
+
+    strings::Rope r("Hello world!");
+    r.insert(5, ",");
+    r += " Bye.";
+    r.erase(0, 7);
+    print("Ex01: Rope: {} (size {}, r[0] = {})\n", r.str(), r.size(), r[0]);
+  }
+
+  /************************************************************************************/
+  // 02_bench_string_builder.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const size_t N = 1'000'000;
+    std::mt19937 gen{2112};
+    vector<string> frags(N);
+    for (auto &f : frags) {
+      f.resize(1 + gen() % 15);
+      for (auto &c : f) c = char('a' + gen() % 26);
+    }
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      auto r = fn();
+      duration<double> elapsed = clock::now() - start;
+      return std::pair{r, elapsed.count()};
+    };
+
+    using tp = const string &;
+    auto concat = [](tp x, tp y) { return x + y; };
+
+    // the fold of 87_ch_13 copies the whole prefix at every step, so it only runs on
+    // the first n fragments; 10x the fragments is 100x the time
+    for (size_t n : {5'000uz, 15'000uz, 50'000uz}) {
+      auto [s, t] = time([&] {
+        return R::fold_left(frags | V::take(n), string(""), concat);
+      });
+      print("Ex02: fold_left x + y     {:>7} fragments {:.4f}s ({} bytes)\n", n, t,
+            s.size());
+    }
+
+    auto [ref, t_move] = time([&] {
+      return R::fold_left(frags, string(""), [](string acc, tp y) {
+        acc += y;
+        return acc;
+      });
+    });
+    auto [built, t_sb] = time([&] {
+      strings::StringBuilder sb;
+      sb.reserve(frags.size());
+      for (auto &f : frags) sb << f;
+      return sb.build();
+    });
+    auto [joined, t_join] = time([&] { return frags | strings::join(); });
+    auto [vjoin, t_vjoin] = time([&] { return frags | V::join | R::to<string>(); });
+    auto [rope, t_rope] = time([&] {
+      strings::Rope r;
+      for (auto &f : frags) r += f;
+      return r.str();
+    });
+    print("Ex02: {} fragments: fold_left acc += y {:.4f}s StringBuilder {:.4f}s\n", N,
+          t_move, t_sb);
+    print("Ex02: {} fragments: join() {:.4f}s V::join|to<string> {:.4f}s", N, t_join,
+          t_vjoin);
+    print(" Rope += {:.4f}s ok {}\n", t_rope,
+          ref == built && ref == joined && ref == vjoin && ref == rope);
+
+    // random edits on the assembled text
+    const size_t E = 5'000;
+    vector<std::pair<size_t, size_t>> edits(E);
+    for (size_t i = 0; auto &[pos, len] : edits) {
+      pos = gen() % (ref.size() + i++);
+      len = 1 + gen() % 8;
+    }
+    auto [s_edit, t_str] = time([&] {
+      auto s = ref;
+      for (auto [pos, len] : edits) s.insert(pos, frags[len]);
+      for (auto [pos, len] : edits) s.erase(pos % (s.size() - len), len);
+      return s;
+    });
+    auto [r_edit, t_redit] = time([&] {
+      strings::Rope r(ref);
+      for (auto [pos, len] : edits) r.insert(pos, frags[len]);
+      for (auto [pos, len] : edits) r.erase(pos % (r.size() - len), len);
+      return r.str();
+    });
+    print("Ex02: {} inserts + {} erases on {} bytes: string {:.4f}s Rope {:.4f}s", E, E,
+          ref.size(), t_str, t_redit);
+    print(" ok {}\n", s_edit == r_edit);
+  }
+}
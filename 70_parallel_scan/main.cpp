@@ -0,0 +1,343 @@
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using std::vector, std::print;
+namespace R = std::ranges;
+
+// Parallel prefix sums and neighbour kernels over contiguous arrays.
+//
+// The scans are two-pass but cache-blocked: the array is walked in rounds of one
+// L2-sized block per thread. In a round every thread first sums its block, the
+// per-block sums are turned into offsets by the last thread to reach a barrier,
+// and then every thread scans its block from its offset while the block is still
+// in cache. Memory is read once and written once, like the sequential scan. Every
+// kernel reads a block before writing it, so out may be the same array as in.
+namespace scan {
+
+inline constexpr size_t block = 32 * 1024;
+
+// cur / prev, 0 where prev is 0: growth factors of a series
+struct ratio {
+  template <typename T>
+  T operator()(T cur, T prev) const {
+    return prev == T{0} ? T{0} : cur / prev;
+  }
+};
+
+namespace detail {
+
+template <typename Fn>
+void for_chunks(size_t n, unsigned n_threads, Fn fn) {
+  if (n_threads <= 1) return fn(0u, size_t{0}, n);
+  vector<std::jthread> pool;
+  for (unsigned t = 0; t < n_threads; ++t)
+    pool.emplace_back(fn, t, n * t / n_threads, n * (t + 1) / n_threads);
+}
+
+inline unsigned threads_for(size_t n, unsigned n_threads) {
+  if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<unsigned>(std::clamp<size_t>(n, 1, n_threads));
+}
+
+#ifdef __AVX2__
+// lanes shifted up by one / two, zeros shifted in
+inline __m256d shift1(__m256d x) {
+  return _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x90), _mm256_setzero_pd(), 0b0001);
+}
+inline __m256d shift2(__m256d x) {
+  return _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x40), _mm256_setzero_pd(), 0b0011);
+}
+// in-register inclusive prefix sum of the four lanes
+inline __m256d prefix4(__m256d x) {
+  x = _mm256_add_pd(x, shift1(x));
+  return _mm256_add_pd(x, shift2(x));
+}
+inline __m256d last_lane(__m256d x) { return _mm256_permute4x64_pd(x, 0xFF); }
+
+template <typename Op>
+constexpr bool has_simd =
+    std::is_same_v<Op, std::minus<>> || std::is_same_v<Op, std::minus<double>> ||
+    std::is_same_v<Op, ratio>;
+
+template <typename Op>
+__m256d apply(Op, __m256d cur, __m256d prev) {
+  if constexpr (std::is_same_v<Op, ratio>) {
+    const auto zero = _mm256_cmp_pd(prev, _mm256_setzero_pd(), _CMP_EQ_OQ);
+    return _mm256_andnot_pd(zero, _mm256_div_pd(cur, prev));
+  } else {
+    return _mm256_sub_pd(cur, prev);
+  }
+}
+#endif
+
+template <typename T>
+T sum(const T *p, size_t n) {
+  size_t i = 0;
+  T s{0};
+#ifdef __AVX2__
+  if constexpr (std::is_same_v<T, double>) {
+    __m256d acc[4] = {};
+    for (; i + 16 <= n; i += 16)
+      for (size_t a = 0; a < 4; ++a)
+        acc[a] = _mm256_add_pd(acc[a], _mm256_loadu_pd(p + i + 4 * a));
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(_mm256_add_pd(acc[0], acc[1]),
+                                         _mm256_add_pd(acc[2], acc[3])));
+    s = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  }
+#endif
+  for (; i < n; ++i) s += p[i];
+  return s;
+}
+
+// out[i] = carry + in[0] + ... + in[i] (Inclusive) or carry + in[0] + ... + in[i-1];
+// returns the carry for the next block
+template <bool Inclusive, typename T>
+T scan_block(const T *in, T *out, size_t n, T carry) {
+  size_t i = 0;
+#ifdef __AVX2__
+  if constexpr (std::is_same_v<T, double>) {
+    auto c = _mm256_set1_pd(carry);
+    for (; i + 4 <= n; i += 4) {
+      const auto x = _mm256_loadu_pd(in + i);
+      const auto r = _mm256_add_pd(c, prefix4(Inclusive ? x : shift1(x)));
+      _mm256_storeu_pd(out + i, r);
+      c = last_lane(Inclusive ? r : _mm256_add_pd(r, x));
+    }
+    carry = _mm256_cvtsd_f64(c);
+  }
+#endif
+  for (; i < n; ++i) {
+    const auto x = in[i];
+    if constexpr (Inclusive) {
+      out[i] = carry += x;
+    } else {
+      out[i] = carry;
+      carry += x;
+    }
+  }
+  return carry;
+}
+
+// out[i] = op(in[i], in[i - 1]) with in[-1] = prev
+template <typename T, typename Op>
+void adjacent_block(const T *in, T *out, size_t n, T prev, Op op) {
+  size_t i = 0;
+#ifdef __AVX2__
+  if constexpr (std::is_same_v<T, double> && has_simd<Op>) {
+    auto p = _mm256_set1_pd(prev);
+    for (; i + 4 <= n; i += 4) {
+      const auto x = _mm256_loadu_pd(in + i);
+      const auto before = _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x90), p, 0b0001);
+      p = last_lane(x);
+      _mm256_storeu_pd(out + i, apply(op, x, before));
+    }
+    prev = _mm256_cvtsd_f64(p);
+  }
+#endif
+  for (; i < n; ++i) {
+    const auto x = in[i];
+    out[i] = op(x, prev);
+    prev = x;
+  }
+}
+
+template <bool Inclusive, typename T>
+void scan(std::span<const T> in, std::span<T> out, T init, unsigned n_threads) {
+  const auto n = in.size();
+  n_threads = threads_for(n / block, n_threads);
+  if (n_threads == 1) {
+    scan_block<Inclusive>(in.data(), out.data(), n, init);
+    return;
+  }
+
+  const auto round = block * n_threads;
+  vector<T> sums(n_threads), offset(n_threads);
+  auto carry = init;
+  auto to_offsets = [&]() noexcept {
+    for (unsigned t = 0; t < n_threads; ++t) {
+      offset[t] = carry;
+      carry += sums[t];
+    }
+  };
+  std::barrier sync(n_threads, to_offsets);
+  for_chunks(n_threads, n_threads, [&](unsigned t, size_t, size_t) {
+    for (size_t r = 0; r < n; r += round) {
+      const auto b = std::min(n, r + t * block), e = std::min(n, b + block);
+      sums[t] = sum(in.data() + b, e - b);
+      sync.arrive_and_wait();
+      scan_block<Inclusive>(in.data() + b, out.data() + b, e - b, offset[t]);
+    }
+  });
+}
+
+}  // namespace detail
+
+template <typename T>
+void inclusive_scan(std::span<const T> in, std::span<T> out, unsigned n_threads = 0) {
+  detail::scan<true>(in, out, T{0}, n_threads);
+}
+
+template <typename T>
+void exclusive_scan(std::span<const T> in, std::span<T> out, T init,
+                    unsigned n_threads = 0) {
+  detail::scan<false>(in, out, init, n_threads);
+}
+
+// out[0] = in[0], out[i] = op(in[i], in[i - 1]) like std::adjacent_difference. The
+// element before each thread's chunk is read up front, so in place is fine.
+// std::minus<> and ratio on doubles have AVX2 bodies.
+template <typename T, typename Op = std::minus<>>
+void adjacent_difference(std::span<const T> in, std::span<T> out, Op op = {},
+                         unsigned n_threads = 0) {
+  const auto n = in.size();
+  if (n == 0) return;
+  n_threads = detail::threads_for(n / block, n_threads);
+  vector<T> edge(n_threads);
+  for (unsigned t = 1; t < n_threads; ++t) edge[t] = in[n * t / n_threads - 1];
+  const auto first = in[0];
+  detail::for_chunks(n, n_threads, [&](unsigned t, size_t b, size_t e) {
+    if (t == 0) {
+      out[0] = first;
+      b = 1;
+    }
+    const auto prev = t ? edge[t] : first;
+    detail::adjacent_block(in.data() + b, out.data() + b, e - b, prev, op);
+  });
+}
+
+}  // namespace scan
+
+int main() {
+  /************************************************************************************/
+  // 01_parallel_scan.cpp
+  {
+    using VD = vector<double>;
+
+    VD values = {8.0, 16.0, 64.0, 256.0, 4096.0};
+    VD ratios(values.size());
+
+    scan::adjacent_difference<double>(values, ratios, scan::ratio{});
+    print("Ex01: Ratios between consecutive elements: {}\n", ratios);
+
+    auto div = [](auto x, auto y) { return (x == 0.0) ? 0.0 : y / x; };
+    scan::adjacent_difference<double>(values, ratios, div);
+    print("Ex01: With the divide lambda of 87_ch_13: {}\n", ratios);
+
+    VD sums(values.size());
+    scan::inclusive_scan<double>(values, sums);
+    print("Ex01: inclusive_scan: {}\n", sums);
+    scan::exclusive_scan<double>(values, values, 1.0);  // in place
+    print("Ex01: exclusive_scan from 1, in place: {}\n", values);
+  }
+
+  /************************************************************************************/
+  // 02_bench_parallel_scan.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+    namespace exe = std::execution;
+
+    // 1e9 doubles, or as many as fit three copies in memory
+    const auto ram =
+        uint64_t(sysconf(_SC_PHYS_PAGES)) * uint64_t(sysconf(_SC_PAGESIZE));
+    size_t N = 1'000'000'000;
+    while (3 * N * sizeof(double) > ram * 3 / 4) N /= 2;
+    const auto hw = std::max(1u, std::thread::hardware_concurrency());
+
+    vector<double> data(N), a(N), b(N);
+    std::mt19937_64 gen{2112};
+    std::uniform_real_distribution<double> price(0.5, 1.5);
+    for (auto &x : data) x = price(gen);
+    std::span<const double> in(data);
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      return elapsed.count();
+    };
+    // the parallel scans add in a different order, so compare with a tolerance
+    auto close = [&] {
+      for (size_t i = 0; i < N; i += 997)
+        if (std::abs(a[i] - b[i]) > 1e-9 * std::abs(a[i])) return false;
+      return std::abs(a[N - 1] - b[N - 1]) <= 1e-9 * std::abs(a[N - 1]);
+    };
+    print("Ex02: N = {}\n", N);
+
+    auto std_row = [&](const char *name, auto seq, auto par) {
+      const auto t_seq = time(seq), t_par = time(par);
+      print("Ex02: {:19} std seq {:.4f}s std par {:.4f}s\n", name, t_seq, t_par);
+    };
+    auto scan_row = [&](const char *name, auto fn, auto check) {
+      for (unsigned t : {1u, 2u, 4u, hw}) {
+        const auto elapsed = time([&] { fn(t); });
+        print("Ex02: {:>19} x{:<2} {:.4f}s ok {}\n", name, t, elapsed, check());
+      }
+    };
+    auto same = [&] { return a == b; };
+    std::span<double> out(b);
+
+    std_row(
+        "inclusive_scan",
+        [&] { std::inclusive_scan(data.begin(), data.end(), a.begin()); },
+        [&] { std::inclusive_scan(exe::par, data.begin(), data.end(), a.begin()); });
+    scan_row("scan::", [&](unsigned t) { scan::inclusive_scan(in, out, t); }, close);
+    scan_row(
+        "in place",
+        [&](unsigned t) {
+          R::copy(data, b.begin());
+          scan::inclusive_scan<double>(b, b, t);
+        },
+        close);
+
+    std_row(
+        "exclusive_scan",
+        [&] { std::exclusive_scan(data.begin(), data.end(), a.begin(), 100.0); },
+        [&] {
+          std::exclusive_scan(exe::par, data.begin(), data.end(), a.begin(), 100.0);
+        });
+    scan_row("scan::", [&](unsigned t) { scan::exclusive_scan(in, out, 100.0, t); },
+             close);
+
+    std_row(
+        "adjacent_difference",
+        [&] { std::adjacent_difference(data.begin(), data.end(), a.begin()); },
+        [&] {
+          std::adjacent_difference(exe::par, data.begin(), data.end(), a.begin());
+        });
+    const std::minus<> minus;
+    scan_row(
+        "scan::", [&](unsigned t) { scan::adjacent_difference(in, out, minus, t); },
+        same);
+
+    const scan::ratio growth;
+    std_row(
+        "ratio",
+        [&] { std::adjacent_difference(data.begin(), data.end(), a.begin(), growth); },
+        [&] {
+          std::adjacent_difference(exe::par, data.begin(), data.end(), a.begin(),
+                                   growth);
+        });
+    scan_row(
+        "scan::", [&](unsigned t) { scan::adjacent_difference(in, out, growth, t); },
+        same);
+  }
+}
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Static search index over a sorted array in Eytzinger (BFS) order: slot 1 is the
+// root and the children of slot k are 2k and 2k + 1, so the first levels of every
+// search share a few hot cache lines. Descending is branch-free, and the slot of a
+// lower bound is recovered at the end from the path bits: it is the last node where
+// the search turned left. With 64 byte alignment the 16 descendants of k four levels
+// down (for 4 byte keys) are the one cache line at 16k, which is prefetched on the
+// way.
+//
+// Answers are indices into the original sorted array, computed from the slot in
+// O(1), so no position array is stored next to the keys.
+template <typename T>
+class EytzingerIndex {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+ public:
+  explicit EytzingerIndex(std::span<const T> sorted)
+      : n(sorted.size()), height(static_cast<size_t>(std::bit_width(n))),
+        tree(static_cast<T *>(std::aligned_alloc(64, bytes_for(n)))) {
+    for (size_t k = 1; k <= n; ++k) tree[k] = sorted[rank(k)];
+  }
+
+  size_t size() const { return n; }
+
+  // index of the first element >= x, size() if there is none
+  size_t lower_bound(const T &x) const {
+    size_t k = 1;
+    for (size_t level = 0; level < height; ++level) {
+      prefetch(k);
+      k = step(k, tree[clamp(k)] < x);
+    }
+    return rank(k >> (std::countr_one(k) + 1));
+  }
+
+  // index of the first element > x, size() if there is none
+  size_t upper_bound(const T &x) const {
+    size_t k = 1;
+    for (size_t level = 0; level < height; ++level) {
+      prefetch(k);
+      k = step(k, !(x < tree[clamp(k)]));
+    }
+    return rank(k >> (std::countr_one(k) + 1));
+  }
+
+  bool contains(const T &x) const {
+    const auto i = lower_bound(x);
+    return i < n && !(x < (*this)[i]);
+  }
+
+  // element i of the sorted input
+  const T &operator[](size_t i) const { return tree[slot(i)]; }
+
+  // lower_bound of every query. Queries descend in groups of `group` in lockstep,
+  // one level per pass, so the group's cache misses are in flight together instead
+  // of one after another.
+  void lower_bound(std::span<const T> queries, std::span<size_t> out) const {
+    constexpr size_t group = 32;
+    size_t k[group];
+    for (size_t b = 0; b < queries.size(); b += group) {
+      const auto g = std::min(group, queries.size() - b);
+      const auto *q = queries.data() + b;
+      std::fill_n(k, g, size_t{1});
+      for (size_t level = 0; level < height; ++level)
+        for (size_t j = 0; j < g; ++j) {
+          prefetch(k[j]);
+          k[j] = step(k[j], tree[clamp(k[j])] < q[j]);
+        }
+      for (size_t j = 0; j < g; ++j)
+        out[b + j] = rank(k[j] >> (std::countr_one(k[j]) + 1));
+    }
+  }
+
+ private:
+  struct Free {
+    void operator()(T *p) const { std::free(p); }
+  };
+
+  // descendants four levels down when 16 keys fill a cache line
+  static constexpr size_t prefetch_stride = std::max<size_t>(1, 64 / sizeof(T));
+
+  // On the last levels 16k is past the array. The address is formed as an integer,
+  // so no out-of-range T * exists, and a prefetch of it is a no-op.
+  void prefetch(size_t k) const {
+    const auto addr =
+        reinterpret_cast<uintptr_t>(tree.get()) + k * prefetch_stride * sizeof(T);
+    __builtin_prefetch(reinterpret_cast<const void *>(addr));
+  }
+
+  static size_t bytes_for(size_t n) { return (((n + 1) * sizeof(T) + 63) / 64) * 64; }
+
+  // Past the last level the path keeps going right, which the recovery strips off
+  // with the other trailing ones. Slots past n are never read.
+  size_t step(size_t k, bool right) const { return 2 * k + (right || k > n); }
+  size_t clamp(size_t k) const { return std::min(k, n); }
+
+  // Sorted index of slot k (n for slot 0, "none"). In a perfect tree of `height`
+  // levels slot k at depth d has 1-based in-order position (2(k - 2^d) + 1) 2^(h-1-d);
+  // the missing slots of a partial last level are the odd positions past the m
+  // filled ones and are subtracted out.
+  size_t rank(size_t k) const {
+    if (k == 0) return n;
+    const auto d = static_cast<size_t>(std::bit_width(k)) - 1;
+    const auto r = (2 * (k - (size_t{1} << d)) + 1) << (height - 1 - d);
+    const auto m = n - ((size_t{1} << (height - 1)) - 1);
+    return r - 1 - (r / 2 > m ? r / 2 - m : 0);
+  }
+
+  // inverse of rank, by the same descent on positions instead of keys
+  size_t slot(size_t i) const {
+    size_t k = 1;
+    for (size_t level = 0; level < height; ++level) k = step(k, rank(clamp(k)) < i);
+    return k >> (std::countr_one(k) + 1);
+  }
+
+  size_t n, height;
+  std::unique_ptr<T[], Free> tree;
+};
+
+int main() {
+  /************************************************************************************/
+  // 01_eytzinger_search.cpp
+  {
+    const vector<int> numbers = {1, 2, 4, 4, 4, 6, 7, 9, 10};
+    EytzingerIndex<int> idx(numbers);
+
+    for (int val : {4, 5, 11, 0}) {
+      print("Ex01: value {:2} lower_bound {} upper_bound {} contains {}\n", val,
+            idx.lower_bound(val), idx.upper_bound(val), idx.contains(val));
+    }
+
+    const vector<int> queries = {0, 3, 4, 8, 10, 12};
+    vector<size_t> out(queries.size());
+    idx.lower_bound(queries, out);
+    print("Ex01: batch lower_bound {} -> {}\n", queries, out);
+  }
+
+  /************************************************************************************/
+  // 02_bench_eytzinger_search.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    // the index is a second copy of the keys; skip sizes that do not fit comfortably
+    const auto ram =
+        uint64_t(sysconf(_SC_PHYS_PAGES)) * uint64_t(sysconf(_SC_PAGESIZE));
+
+    std::mt19937 gen{2112};
+    const size_t Q = 1 << 22;
+    for (auto n : {1uz << 10, 1uz << 15, 1uz << 20, 1uz << 25, 1uz << 28, 1uz << 30}) {
+      if (3 * n * sizeof(uint32_t) > ram) {
+        print("Ex02: n={:<11} skipped, needs {} GiB\n", n, 3 * n * 4 >> 30);
+        continue;
+      }
+      vector<uint32_t> sorted(n);
+      uint32_t x = 0;
+      for (auto &e : sorted) e = x += gen() % 4;  // duplicates included
+
+      vector<uint32_t> queries(Q);
+      R::generate(queries, [&] { return uint32_t(gen() % (uint64_t(x) + 2)); });
+
+      auto time = [&](auto fn) {
+        auto start = clock::now();
+        fn();
+        duration<double> elapsed = clock::now() - start;
+        return double(Q) / elapsed.count() / 1e6;
+      };
+
+      vector<size_t> ref(Q), one(Q), batch(Q);
+      const auto t_std = time([&] {
+        for (size_t i = 0; i < Q; ++i)
+          ref[i] = size_t(R::lower_bound(sorted, queries[i]) - sorted.begin());
+      });
+      EytzingerIndex<uint32_t> idx(sorted);
+      const auto t_one = time([&] {
+        for (size_t i = 0; i < Q; ++i) one[i] = idx.lower_bound(queries[i]);
+      });
+      const auto t_batch = time([&] { idx.lower_bound(queries, batch); });
+
+      print("Ex02: n={:<11} Mq/s std::lower_bound {:7.2f} eytzinger {:7.2f}", n, t_std,
+            t_one);
+      print(" batch {:7.2f} ok {}\n", t_batch, ref == one && ref == batch);
+    }
+  }
+}
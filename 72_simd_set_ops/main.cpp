@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Set algebra on sorted, duplicate-free arrays of uint32_t / uint64_t.
+//
+// Sizes of the same order go through a block merge. One block of a (8 x uint32 or
+// 4 x uint64, one ymm register) is compared against one block of b in every lane
+// rotation, and the hits are ORed into a mask. Whichever block has the smaller last
+// element is retired, and when an a block retires its hits (intersection) or misses
+// (difference) are compressed into the output with one permute from a lookup
+// table. When one side is more than gallop_ratio times the other, every element of
+// the small side is found in the large one by exponential then binary search.
+namespace sets {
+
+inline constexpr size_t gallop_ratio = 32;
+
+enum class Op { intersect, subtract };
+
+namespace detail {
+
+#ifdef __AVX2__
+template <typename T>
+struct simd;
+
+template <>
+struct simd<uint32_t> {
+  static constexpr size_t lanes = 8;
+
+  // rotate[r] moves lane (l + r) % 8 to lane l
+  alignas(32) static constexpr auto rotate = [] {
+    std::array<std::array<uint32_t, 8>, 8> t{};
+    for (uint32_t r = 0; r < 8; ++r)
+      for (uint32_t l = 0; l < 8; ++l) t[r][l] = (l + r) % 8;
+    return t;
+  }();
+  // compress[m] gathers the lanes set in m to the front
+  alignas(32) static constexpr auto compress = [] {
+    std::array<std::array<uint32_t, 8>, 256> t{};
+    for (uint32_t m = 0; m < 256; ++m)
+      for (uint32_t l = 0, k = 0; l < 8; ++l)
+        if (m >> l & 1) t[m][k++] = l;
+    return t;
+  }();
+
+  static __m256i load(const uint32_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  static __m256i table(const std::array<uint32_t, 8> &row) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(row.data()));
+  }
+
+  // bit l set when lane l of a equals some lane of b
+  static unsigned match(__m256i a, __m256i b) {
+    auto eq = _mm256_cmpeq_epi32(a, b);
+    for (size_t r = 1; r < 8; ++r) {
+      const auto br = _mm256_permutevar8x32_epi32(b, table(rotate[r]));
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(a, br));
+    }
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+  }
+
+  // writes all 8 lanes, the selected ones first
+  static void store(uint32_t *out, __m256i a, unsigned mask) {
+    const auto packed = _mm256_permutevar8x32_epi32(a, table(compress[mask]));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), packed);
+  }
+};
+
+template <>
+struct simd<uint64_t> {
+  static constexpr size_t lanes = 4;
+
+  // 64 bit lanes are moved as pairs of 32 bit lanes
+  alignas(32) static constexpr auto compress = [] {
+    std::array<std::array<uint32_t, 8>, 16> t{};
+    for (uint32_t m = 0; m < 16; ++m)
+      for (uint32_t l = 0, k = 0; l < 4; ++l)
+        if (m >> l & 1) {
+          t[m][2 * k] = 2 * l;
+          t[m][2 * k + 1] = 2 * l + 1;
+          ++k;
+        }
+    return t;
+  }();
+
+  static __m256i load(const uint64_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+
+  static unsigned match(__m256i a, __m256i b) {
+    auto eq = _mm256_cmpeq_epi64(a, b);
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x39)));
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x4E)));
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x93)));
+    return static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+  }
+
+  static void store(uint64_t *out, __m256i a, unsigned mask) {
+    const auto *row = compress[mask].data();
+    const auto idx = _mm256_load_si256(reinterpret_cast<const __m256i *>(row));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out),
+                        _mm256_permutevar8x32_epi32(a, idx));
+  }
+};
+#endif
+
+// Block merge. Returns the size of a & b or a - b; with Write the result also goes to
+// out, which needs room for |a| elements because whole blocks are stored. out may be
+// a itself: nothing is written past the block being retired.
+template <Op op, bool Write, typename T>
+size_t merge(std::span<const T> a, std::span<const T> b, T *out) {
+  size_t i = 0, j = 0, k = 0;
+  unsigned seen = 0;  // lanes of the a block at i matched so far
+#ifdef __AVX2__
+  if constexpr (requires { simd<T>::lanes; }) {
+    using S = simd<T>;
+    constexpr auto L = S::lanes;
+    constexpr unsigned all = (1u << L) - 1;
+    while (i + L <= a.size() && j + L <= b.size()) {
+      const auto va = S::load(&a[i]);
+      seen |= S::match(va, S::load(&b[j]));
+      const auto a_last = a[i + L - 1], b_last = b[j + L - 1];
+      if (a_last <= b_last) {
+        const auto keep = op == Op::intersect ? seen : ~seen & all;
+        if constexpr (Write) S::store(out + k, va, keep);
+        k += static_cast<size_t>(std::popcount(keep));
+        seen = 0;
+        i += L;
+      }
+      if (b_last <= a_last) j += L;
+    }
+  }
+#endif
+  // scalar tail; the low bits of seen are a[i..] matched by blocks already retired
+  for (; i < a.size(); ++i, seen >>= 1) {
+    const auto x = a[i];
+    while (j < b.size() && b[j] < x) ++j;
+    const bool hit = (seen & 1) || (j < b.size() && b[j] == x);
+    if (hit == (op == Op::intersect)) {
+      if constexpr (Write) out[k] = x;
+      ++k;
+    }
+  }
+  return k;
+}
+
+// first index >= from with b[index] >= x: doubling steps, then a binary search
+// inside the last step
+template <typename T>
+size_t gallop(std::span<const T> b, size_t from, T x) {
+  size_t step = 1;
+  while (from + step < b.size() && b[from + step] < x) step *= 2;
+  const auto lo = from + step / 2, hi = std::min(from + step + 1, b.size());
+  const auto it = std::lower_bound(b.begin() + static_cast<std::ptrdiff_t>(lo),
+                                   b.begin() + static_cast<std::ptrdiff_t>(hi), x);
+  return static_cast<size_t>(it - b.begin());
+}
+
+// looks every element of a up in the much larger b
+template <Op op, bool Write, typename T>
+size_t gallop_small(std::span<const T> a, std::span<const T> b, T *out) {
+  size_t j = 0, k = 0;
+  for (auto x : a) {
+    if (j < b.size()) j = gallop(b, j, x);
+    const bool hit = j < b.size() && b[j] == x;
+    if (hit == (op == Op::intersect)) {
+      if constexpr (Write) out[k] = x;
+      ++k;
+    }
+  }
+  return k;
+}
+
+// a - b for a much larger a: each element of b is found in a, and the run of a
+// before it is copied as a block
+template <bool Write, typename T>
+size_t gallop_subtract_large(std::span<const T> a, std::span<const T> b, T *out) {
+  size_t i = 0, k = 0;
+  for (auto y : b) {
+    if (i == a.size()) break;
+    const auto p = gallop(a, i, y);
+    if constexpr (Write) std::memmove(out + k, a.data() + i, (p - i) * sizeof(T));
+    k += p - i;
+    i = p + (p < a.size() && a[p] == y);
+  }
+  if constexpr (Write) std::memmove(out + k, a.data() + i, (a.size() - i) * sizeof(T));
+  return k + a.size() - i;
+}
+
+template <Op op, bool Write, typename T>
+size_t dispatch(std::span<const T> a, std::span<const T> b, T *out) {
+  if (a.empty() || b.empty()) {
+    if constexpr (op == Op::subtract && Write) R::copy(a, out);
+    return op == Op::subtract ? a.size() : 0;
+  }
+  if constexpr (op == Op::intersect)
+    if (a.size() > b.size()) std::swap(a, b);
+  if (a.size() * gallop_ratio < b.size()) return gallop_small<op, Write>(a, b, out);
+  if constexpr (op == Op::subtract)
+    if (b.size() * gallop_ratio < a.size())
+      return gallop_subtract_large<Write>(a, b, out);
+  return merge<op, Write>(a, b, out);
+}
+
+}  // namespace detail
+
+// a & b into out (room for min(|a|, |b|) elements), returns the size
+template <typename T>
+size_t intersect(std::span<const T> a, std::span<const T> b, T *out) {
+  return detail::dispatch<Op::intersect, true>(a, b, out);
+}
+
+template <typename T>
+size_t intersect_count(std::span<const T> a, std::span<const T> b) {
+  return detail::dispatch<Op::intersect, false, T>(a, b, nullptr);
+}
+
+// a - b into out (room for |a| elements), returns the size
+template <typename T>
+size_t subtract(std::span<const T> a, std::span<const T> b, T *out) {
+  return detail::dispatch<Op::subtract, true>(a, b, out);
+}
+
+template <typename T>
+size_t subtract_count(std::span<const T> a, std::span<const T> b) {
+  return detail::dispatch<Op::subtract, false, T>(a, b, nullptr);
+}
+
+// a | b into out (room for |a| + |b| elements), returns the size. A union has to
+// interleave both inputs, so the balanced case is a branch-free scalar merge; the
+// skewed case copies the runs of the large side between small elements as blocks.
+template <typename T>
+size_t unite(std::span<const T> a, std::span<const T> b, T *out) {
+  if (a.size() > b.size()) std::swap(a, b);
+  size_t i = 0, j = 0, k = 0;
+  if (a.size() * gallop_ratio < b.size()) {
+    for (auto x : a) {
+      const auto p = j < b.size() ? detail::gallop(b, j, x) : b.size();
+      std::memcpy(out + k, b.data() + j, (p - j) * sizeof(T));
+      k += p - j;
+      out[k++] = x;
+      j = p + (p < b.size() && b[p] == x);
+    }
+  } else {
+    while (i < a.size() && j < b.size()) {
+      const auto x = a[i], y = b[j];
+      out[k++] = std::min(x, y);
+      i += x <= y;
+      j += y <= x;
+    }
+    std::memcpy(out + k, a.data() + i, (a.size() - i) * sizeof(T));
+    k += a.size() - i;
+  }
+  std::memcpy(out + k, b.data() + j, (b.size() - j) * sizeof(T));
+  return k + b.size() - j;
+}
+
+// k-way intersection, smallest lists first so the running result shrinks as fast as
+// possible and the later steps gallop. out needs room for the smallest list.
+template <typename T>
+size_t intersect(std::span<const std::span<const T>> lists, T *out) {
+  if (lists.empty()) return 0;
+  vector<std::span<const T>> by_size(lists.begin(), lists.end());
+  R::sort(by_size, {}, [](const auto &s) { return s.size(); });
+  auto k = by_size[0].size();
+  R::copy(by_size[0], out);
+  for (auto &l : by_size | V::drop(1)) {
+    if (k == 0) break;
+    k = intersect(std::span<const T>(out, k), l, out);
+  }
+  return k;
+}
+
+template <typename T>
+size_t intersect_count(std::span<const std::span<const T>> lists) {
+  if (lists.size() < 2) return lists.empty() ? 0 : lists[0].size();
+  vector<std::span<const T>> by_size(lists.begin(), lists.end());
+  R::sort(by_size, {}, [](const auto &s) { return s.size(); });
+  const auto rest = std::span(by_size).first(by_size.size() - 1);
+  vector<T> acc(rest[0].size());
+  const auto k = intersect(std::span<const std::span<const T>>(rest), acc.data());
+  return intersect_count(std::span<const T>(acc.data(), k), by_size.back());
+}
+
+}  // namespace sets
+
+int main() {
+  /************************************************************************************/
+  // 01_simd_set_ops.cpp
+  {
+    const vector<uint32_t> set1 = {10, 20, 30, 40, 50};
+    const vector<uint32_t> set2 = {30, 40, 50, 60, 70};
+    std::span<const uint32_t> s1(set1), s2(set2);
+
+    vector<uint32_t> out(set1.size() + set2.size());
+    auto n = sets::intersect(s1, s2, out.data());
+    print("Ex01: Intersection: {}\n", out | V::take(n));
+    n = sets::subtract(s1, s2, out.data());
+    print("Ex01: Difference: {}\n", out | V::take(n));
+    n = sets::unite(s1, s2, out.data());
+    print("Ex01: Union: {}\n", out | V::take(n));
+    print("Ex01: Intersection size: {}\n", sets::intersect_count(s1, s2));
+
+    const vector<uint64_t> a = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21};
+    const vector<uint64_t> b = {3, 6, 9, 12, 15, 18, 21};
+    const vector<uint64_t> c = {5, 9, 15, 21, 25};
+    const std::array<std::span<const uint64_t>, 3> lists{a, b, c};
+    vector<uint64_t> abc(c.size());
+    n = sets::intersect(std::span<const std::span<const uint64_t>>(lists), abc.data());
+    print("Ex01: 3-way intersection: {}\n", abc | V::take(n));
+  }
+
+  /************************************************************************************/
+  // 02_bench_simd_set_ops.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    // sorted, duplicate-free posting list of n ids spread over [0, n * spread)
+    std::mt19937_64 gen{2112};
+    auto posting = [&]<typename T>(size_t n, uint64_t spread, T) {
+      vector<T> v(n);
+      uint64_t x = 0;
+      for (auto &e : v) e = static_cast<T>(x += 1 + gen() % (2 * spread - 1));
+      return v;
+    };
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      auto r = fn();
+      duration<double> elapsed = clock::now() - start;
+      return std::pair{r, elapsed.count()};
+    };
+
+    // intersections of a 1e7 list with lists ratio times smaller; the smaller lists
+    // cover the same id range so the hit rate stays about the same
+    const size_t N = 10'000'000;
+    const auto big = posting(N, 2, uint32_t{});
+    std::span<const uint32_t> sb(big);
+    for (size_t ratio : {1uz, 4uz, 16uz, 64uz, 256uz, 4096uz}) {
+      const auto small = posting(N / ratio, 2 * ratio, uint32_t{});
+      std::span<const uint32_t> ss(small);
+
+      vector<uint32_t> ref(small.size()), out(small.size());
+      auto [e, t_std] = time([&] {
+        return std::set_intersection(big.begin(), big.end(), small.begin(), small.end(),
+                                     ref.begin()) -
+               ref.begin();
+      });
+      auto [n, t_simd] = time([&] { return sets::intersect(sb, ss, out.data()); });
+      auto [c, t_cnt] = time([&] { return sets::intersect_count(sb, ss); });
+      const bool ok =
+          size_t(e) == n && c == n && R::equal(ref | V::take(e), out | V::take(n));
+      print("Ex02: u32 1e7 & 1e7/{:<4} std {:.4f}s sets {:.4f}s count {:.4f}s ok {}\n",
+            ratio, t_std, t_simd, t_cnt, ok);
+    }
+
+    // difference and union, balanced and skewed
+    for (size_t ratio : {1uz, 64uz}) {
+      const auto small = posting(N / ratio, 2 * ratio, uint32_t{});
+      std::span<const uint32_t> ss(small);
+      vector<uint32_t> ref(N + small.size()), out(N + small.size());
+
+      auto [e, t_std] = time([&] {
+        return std::set_difference(big.begin(), big.end(), small.begin(), small.end(),
+                                   ref.begin()) -
+               ref.begin();
+      });
+      auto [n, t_sets] = time([&] { return sets::subtract(sb, ss, out.data()); });
+      bool ok = size_t(e) == n && R::equal(ref | V::take(e), out | V::take(n));
+      print("Ex02: u32 1e7 - 1e7/{:<4} std {:.4f}s sets {:.4f}s ok {}\n", ratio, t_std,
+            t_sets, ok);
+
+      auto [ue, t_ustd] = time([&] {
+        return std::set_union(big.begin(), big.end(), small.begin(), small.end(),
+                              ref.begin()) -
+               ref.begin();
+      });
+      auto [un, t_usets] = time([&] { return sets::unite(sb, ss, out.data()); });
+      ok = size_t(ue) == un && R::equal(ref | V::take(ue), out | V::take(un));
+      print("Ex02: u32 1e7 | 1e7/{:<4} std {:.4f}s sets {:.4f}s ok {}\n", ratio, t_ustd,
+            t_usets, ok);
+    }
+
+    // 64 bit ids
+    {
+      const auto a = posting(N, 2, uint64_t{}), b = posting(N, 2, uint64_t{});
+      vector<uint64_t> ref(N), out(N);
+      auto [e, t_std] = time([&] {
+        return std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                                     ref.begin()) -
+               ref.begin();
+      });
+      std::span<const uint64_t> sa(a), sb64(b);
+      auto [n, t_sets] = time([&] { return sets::intersect(sa, sb64, out.data()); });
+      const bool ok = size_t(e) == n && R::equal(ref | V::take(e), out | V::take(n));
+      print("Ex02: u64 1e7 & 1e7      std {:.4f}s sets {:.4f}s ok {}\n", t_std, t_sets,
+            ok);
+    }
+
+    // 4-way: the chained std::set_intersection baseline goes in the given order
+    {
+      const auto l1 = posting(N, 2, uint32_t{}), l2 = posting(N / 2, 4, uint32_t{});
+      const auto l3 = posting(N / 8, 16, uint32_t{});
+      const std::array<std::span<const uint32_t>, 4> lists{sb, l1, l2, l3};
+      auto [ref, t_std] = time([&] {
+        vector<uint32_t> acc(big), next;
+        for (auto &l : lists | V::drop(1)) {
+          next.clear();
+          std::set_intersection(acc.begin(), acc.end(), l.begin(), l.end(),
+                                std::back_inserter(next));
+          acc.swap(next);
+        }
+        return acc;
+      });
+      vector<uint32_t> out(l3.size());
+      auto span4 = std::span<const std::span<const uint32_t>>(lists);
+      auto [n, t_sets] = time([&] { return sets::intersect(span4, out.data()); });
+      auto [c, t_cnt] = time([&] { return sets::intersect_count(span4); });
+      const bool ok = n == ref.size() && c == n && R::equal(ref, out | V::take(n));
+      print("Ex02: 4-way              std {:.4f}s sets {:.4f}s count {:.4f}s ok {}\n",
+            t_std, t_sets, t_cnt, ok);
+    }
+  }
+}
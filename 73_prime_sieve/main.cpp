@@ -0,0 +1,559 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+__extension__ using u128 = unsigned __int128;
+
+// Prime enumeration and primality tests for large batches of integers.
+//
+// The sieve stores only numbers coprime to 30 (the 2*3*5 wheel): 8 residues per 30
+// numbers, one bit each, so a byte covers 30 numbers. [lo, hi) is sieved one
+// L1-sized segment at a time with the base primes up to sqrt(hi), and segments are
+// spread over threads. Numbers past the sieved range fall back to a deterministic
+// Miller-Rabin test in Montgomery form.
+namespace sieve {
+
+inline constexpr std::array<uint8_t, 8> wheel{1, 7, 11, 13, 17, 19, 23, 29};
+inline constexpr std::array<uint8_t, 8> gap{6, 4, 2, 4, 2, 4, 6, 2};
+// bit of each residue mod 30 within a byte, 8 for residues that share a factor with 30
+inline constexpr auto bit_of = [] {
+  std::array<uint8_t, 30> b{};
+  b.fill(8);
+  for (uint8_t i = 0; i < 8; ++i) b[wheel[i]] = i;
+  return b;
+}();
+
+inline constexpr size_t segment_bytes = 32 * 1024;
+inline constexpr uint64_t segment_span = 30 * segment_bytes;
+inline constexpr uint64_t max_value = uint64_t{1} << 62;
+
+namespace detail {
+
+template <typename Fn>
+void for_chunks(size_t n, unsigned n_threads, Fn fn) {
+  if (n_threads <= 1) return fn(0u, size_t{0}, n);
+  vector<std::jthread> pool;
+  for (unsigned t = 0; t < n_threads; ++t)
+    pool.emplace_back(fn, t, n * t / n_threads, n * (t + 1) / n_threads);
+}
+
+inline unsigned threads_for(size_t n, unsigned n_threads) {
+  if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<unsigned>(std::clamp<size_t>(n, 1, n_threads));
+}
+
+inline uint64_t isqrt(uint64_t n) {
+  auto r = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+  while (r * r > n) --r;
+  while ((r + 1) * (r + 1) <= n) ++r;
+  return r;
+}
+
+inline uint64_t popcount_bytes(const uint8_t *p, size_t n) {
+  uint64_t c = 0;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t w;
+    std::memcpy(&w, p + i, 8);
+    c += static_cast<uint64_t>(std::popcount(w));
+  }
+  for (; i < n; ++i) c += static_cast<uint64_t>(std::popcount(p[i]));
+  return c;
+}
+
+// calls fn(prime) for every set bit of n bytes whose first byte starts at `first`
+template <typename Fn>
+void scan_bytes(const uint8_t *seg, size_t n, uint64_t first, Fn &fn) {
+  for (size_t k = 0; k < n; ++k)
+    for (unsigned bits = seg[k]; bits; bits &= bits - 1)
+      fn(first + 30 * k + wheel[static_cast<size_t>(std::countr_zero(bits))]);
+}
+
+inline constexpr std::array<uint64_t, 3> below_wheel{2, 3, 5};
+
+}  // namespace detail
+
+// all primes < n by a plain byte sieve, used for the base primes up to sqrt(hi)
+inline vector<uint32_t> small_primes(uint32_t n) {
+  vector<uint8_t> composite(n);
+  vector<uint32_t> out;
+  for (uint64_t i = 2; i < n; ++i) {
+    if (composite[i]) continue;
+    out.push_back(static_cast<uint32_t>(i));
+    for (auto j = i * i; j < n; j += i) composite[j] = 1;
+  }
+  return out;
+}
+
+inline vector<uint32_t> base_primes(uint64_t hi) {
+  return small_primes(static_cast<uint32_t>(detail::isqrt(hi) + 1));
+}
+
+// bytes needed to sieve [lo, hi)
+inline size_t segment_size(uint64_t lo, uint64_t hi) {
+  return static_cast<size_t>((hi + 29) / 30 - lo / 30);
+}
+
+// Sieve [lo, hi) into out, one bit per number coprime to 30: bit i of out[k] is
+// 30 * (lo / 30 + k) + wheel[i]. base must hold the primes up to sqrt(hi). Every
+// prime p >= 7 crosses off p * m for the m >= p coprime to 30, walking m around the
+// wheel, so no composite with a factor 2, 3 or 5 is ever visited.
+inline void sieve_segment(uint64_t lo, uint64_t hi, std::span<const uint32_t> base,
+                          uint8_t *out) {
+  const auto n = segment_size(lo, hi);
+  const uint64_t first = lo / 30 * 30, end = first + 30 * n;
+  std::fill(out, out + n, uint8_t{0xFF});
+  if (first == 0) out[0] &= 0xFE;  // 1 is not prime
+
+  for (uint64_t p : base) {
+    if (p < 7) continue;
+    if (p * p >= hi) break;
+    auto m = std::max(p, (first + p - 1) / p);
+    while (bit_of[m % 30] == 8) ++m;
+    for (auto q = p * m, w = uint64_t{bit_of[m % 30]}; q < end; w = (w + 1) & 7) {
+      const auto off = q - first;
+      out[off / 30] &= static_cast<uint8_t>(~(1u << bit_of[off % 30]));
+      q += p * gap[w];
+    }
+  }
+
+  // the first and last byte may hold numbers outside [lo, hi)
+  for (unsigned i = 0; i < 8; ++i) {
+    if (first + wheel[i] < lo) out[0] &= static_cast<uint8_t>(~(1u << i));
+    if (end - 30 + wheel[i] >= hi) out[n - 1] &= static_cast<uint8_t>(~(1u << i));
+  }
+}
+
+// number of primes in [lo, hi)
+inline uint64_t count_primes(uint64_t lo, uint64_t hi, unsigned n_threads = 0) {
+  uint64_t total = 0;
+  for (auto p : detail::below_wheel) total += p >= lo && p < hi;
+  if (lo >= hi) return total;
+
+  const auto base = base_primes(hi);
+  const auto n_segments = static_cast<size_t>((hi - lo - 1) / segment_span + 1);
+  n_threads = detail::threads_for(n_segments, n_threads);
+  struct alignas(64) Part {
+    uint64_t n{0};
+  };
+  vector<Part> parts(n_threads);
+  detail::for_chunks(n_segments, n_threads, [&](unsigned t, size_t sb, size_t se) {
+    vector<uint8_t> seg(segment_bytes + 1);
+    for (auto s = sb; s < se; ++s) {
+      const auto a = lo + s * segment_span, b = std::min(hi, a + segment_span);
+      sieve_segment(a, b, base, seg.data());
+      parts[t].n += detail::popcount_bytes(seg.data(), segment_size(a, b));
+    }
+  });
+  for (auto p : parts) total += p.n;
+  return total;
+}
+
+// calls fn(p) for every prime in [lo, hi), in increasing order
+template <typename Fn>
+void for_each_prime(uint64_t lo, uint64_t hi, Fn fn) {
+  for (auto p : detail::below_wheel)
+    if (p >= lo && p < hi) fn(p);
+  if (lo >= hi) return;
+
+  const auto base = base_primes(hi);
+  vector<uint8_t> seg(segment_bytes + 1);
+  for (auto a = lo; a < hi; a += segment_span) {
+    const auto b = std::min(hi, a + segment_span);
+    sieve_segment(a, b, base, seg.data());
+    detail::scan_bytes(seg.data(), segment_size(a, b), a / 30 * 30, fn);
+  }
+}
+
+// every prime in [lo, hi) in increasing order; threads sieve their own segments into
+// local buffers, then the output is allocated once and the parts moved in
+inline vector<uint64_t> primes_between(uint64_t lo, uint64_t hi,
+                                       unsigned n_threads = 0) {
+  vector<uint64_t> head;
+  for (auto p : detail::below_wheel)
+    if (p >= lo && p < hi) head.push_back(p);
+  if (lo >= hi) return head;
+
+  const auto base = base_primes(hi);
+  const auto n_segments = static_cast<size_t>((hi - lo - 1) / segment_span + 1);
+  n_threads = detail::threads_for(n_segments, n_threads);
+  vector<vector<uint64_t>> parts(n_threads);
+  detail::for_chunks(n_segments, n_threads, [&](unsigned t, size_t sb, size_t se) {
+    vector<uint8_t> seg(segment_bytes + 1);
+    auto push = [&](uint64_t p) { parts[t].push_back(p); };
+    // density of primes near x is 1/ln x, so this overestimates the count a little
+    const auto a0 = lo + sb * segment_span, a1 = std::min(hi, lo + se * segment_span);
+    const auto ln = std::log(static_cast<double>(std::max<uint64_t>(a0, 16)));
+    parts[t].reserve(static_cast<size_t>(double(a1 - a0) / ln * 1.2) + 64);
+    for (auto s = sb; s < se; ++s) {
+      const auto a = lo + s * segment_span, b = std::min(hi, a + segment_span);
+      sieve_segment(a, b, base, seg.data());
+      detail::scan_bytes(seg.data(), segment_size(a, b), a / 30 * 30, push);
+    }
+  });
+
+  size_t total = head.size();
+  for (auto &p : parts) total += p.size();
+  head.reserve(total);
+  for (auto &p : parts) head.insert(head.end(), p.begin(), p.end());
+  return head;
+}
+
+// Montgomery arithmetic modulo an odd n, R = 2^64. Values stay in [0, n) in
+// Montgomery form, so a product is one 64x64->128 multiply and one reduction
+// instead of a 128-bit division.
+class Montgomery {
+ public:
+  explicit Montgomery(uint64_t n) : n(n), n_inv(inverse(n)), r1(-n % n) {
+    r2 = static_cast<uint64_t>(u128(r1) * r1 % n);
+  }
+
+  uint64_t one() const { return r1; }
+  uint64_t to(uint64_t a) const { return mul(a % n, r2); }
+  uint64_t mul(uint64_t a, uint64_t b) const { return reduce(u128(a) * b); }
+
+  uint64_t pow(uint64_t a, uint64_t e) const {
+    auto r = r1;
+    for (; e; e >>= 1, a = mul(a, a))
+      if (e & 1) r = mul(r, a);
+    return r;
+  }
+
+ private:
+  // n^-1 mod 2^64 by Newton's iteration, every step doubles the correct bits
+  static uint64_t inverse(uint64_t n) {
+    auto x = n;
+    for (int i = 0; i < 5; ++i) x *= 2 - n * x;
+    return x;
+  }
+
+  // t * R^-1 mod n for t < n * R
+  uint64_t reduce(u128 t) const {
+    const auto m = static_cast<uint64_t>(t) * n_inv;
+    const auto hi = static_cast<uint64_t>(t >> 64);
+    const auto mn = static_cast<uint64_t>((u128(m) * n) >> 64);
+    return hi >= mn ? hi - mn : hi - mn + n;
+  }
+
+  uint64_t n, n_inv, r1, r2{0};
+};
+
+// Deterministic for every n < 2^64 with the seven bases of Jim Sinclair.
+inline bool miller_rabin(uint64_t n) {
+  if (n < 2) return false;
+  for (uint64_t p : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37})
+    if (n % p == 0) return n == p;
+  if (n < 41 * 41) return true;
+
+  const Montgomery m(n);
+  const auto s = std::countr_zero(n - 1);
+  const auto d = (n - 1) >> s;
+  const auto one = m.one(), minus_one = n - one;
+  for (uint64_t a : {2, 325, 9375, 28178, 450775, 9780504, 1795265022}) {
+    if (a % n == 0) continue;
+    auto x = m.pow(m.to(a), d);
+    if (x == one || x == minus_one) continue;
+    bool composite = true;
+    for (int i = 1; i < s && composite; ++i) {
+      x = m.mul(x, x);
+      composite = x != minus_one;
+    }
+    if (composite) return false;
+  }
+  return true;
+}
+
+// Predicate for V::filter: a bit table of [lo, hi) sieved in parallel up front, with
+// Miller-Rabin for anything outside it. Copies share the table.
+class PrimeTest {
+ public:
+  PrimeTest(uint64_t lo, uint64_t hi, unsigned n_threads = 0)
+      : lo(lo), hi(std::max(lo, hi)), first_byte(lo / 30) {
+    if (lo >= hi) return;
+    auto table = std::make_shared<vector<uint8_t>>(segment_size(lo, hi));
+    const auto base = base_primes(hi);
+    // segments after the first start on a byte boundary, so threads never share one
+    const auto first = 30 * first_byte;
+    const auto n_segments = static_cast<size_t>((hi - first - 1) / segment_span + 1);
+    n_threads = detail::threads_for(n_segments, n_threads);
+    detail::for_chunks(n_segments, n_threads, [&](unsigned, size_t sb, size_t se) {
+      for (auto s = sb; s < se; ++s) {
+        const auto a = std::max(lo, first + s * segment_span);
+        const auto b = std::min(hi, first + (s + 1) * segment_span);
+        sieve_segment(a, b, base, table->data() + s * segment_bytes);
+      }
+    });
+    bits = std::move(table);
+  }
+
+  template <std::integral I>
+  bool operator()(I x) const {
+    if (x < 2) return false;
+    const auto n = static_cast<uint64_t>(x);
+    if (n < lo || n >= hi) return miller_rabin(n);
+    if (n < 7) return n != 4 && n != 6;
+    const auto b = bit_of[n % 30];
+    return b != 8 && ((*bits)[n / 30 - first_byte] >> b & 1);
+  }
+
+ private:
+  uint64_t lo, hi, first_byte;
+  std::shared_ptr<const vector<uint8_t>> bits;
+};
+
+inline PrimeTest is_prime(uint64_t lo, uint64_t hi, unsigned n_threads = 0) {
+  return {lo, hi, n_threads};
+}
+
+// Batch test: the primes of xs, in order. When the values are dense enough that a
+// sieve of [min, max] costs less than a few bytes per input it is built and looked
+// up; otherwise every value gets Miller-Rabin. Inputs are split over threads.
+template <std::integral T>
+vector<T> select_primes(std::span<const T> xs, unsigned n_threads = 0) {
+  if (xs.empty()) return {};
+  const auto [mn, mx] = R::minmax(xs);
+  const auto lo = static_cast<uint64_t>(std::max<T>(mn, 0));
+  const auto hi = mx < 0 ? lo : static_cast<uint64_t>(mx) + 1;
+  const bool dense = (hi - lo) / 30 <= 4 * xs.size();
+  const auto test = dense ? PrimeTest(lo, hi, n_threads) : PrimeTest(0, 0);
+
+  n_threads = detail::threads_for(xs.size() / 16384, n_threads);
+  vector<vector<T>> parts(n_threads);
+  detail::for_chunks(xs.size(), n_threads, [&](unsigned t, size_t b, size_t e) {
+    for (auto x : xs.subspan(b, e - b))
+      if (test(x)) parts[t].push_back(x);
+  });
+  vector<T> out;
+  size_t total = 0;
+  for (auto &p : parts) total += p.size();
+  out.reserve(total);
+  for (auto &p : parts) out.insert(out.end(), p.begin(), p.end());
+  return out;
+}
+
+// Lazy view of the primes in [lo, hi), sieved one segment at a time as the iterator
+// advances. The base primes grow with the segments, so primes(lo) is unbounded for
+// practical purposes (up to max_value).
+class primes_view : public R::view_interface<primes_view> {
+ public:
+  class iterator {
+   public:
+    using value_type = uint64_t;
+    using difference_type = std::ptrdiff_t;
+
+    iterator() = default;
+    iterator(uint64_t lo, uint64_t hi) : hi(hi) {
+      if (lo >= hi) {
+        value = hi;
+        return;
+      }
+      small = static_cast<unsigned>(R::count_if(detail::below_wheel,
+                                                [&](uint64_t p) { return p < lo; }));
+      load(lo);
+      advance();
+    }
+
+    uint64_t operator*() const { return value; }
+    iterator &operator++() {
+      advance();
+      return *this;
+    }
+    void operator++(int) { advance(); }
+    bool operator==(std::default_sentinel_t) const { return value >= hi; }
+
+   private:
+    void load(uint64_t a) {
+      seg_hi = std::min(hi, a + segment_span);
+      if (base_limit * base_limit < seg_hi) {
+        base_limit = std::max(2 * base_limit, detail::isqrt(seg_hi) + 1);
+        base = std::make_shared<const vector<uint32_t>>(
+            small_primes(static_cast<uint32_t>(base_limit)));
+      }
+      seg.resize(segment_size(a, seg_hi));
+      sieve_segment(a, seg_hi, *base, seg.data());
+      first = a / 30 * 30;
+      byte = 0;
+      bits = seg[0];
+    }
+
+    void advance() {
+      if (small < detail::below_wheel.size()) {
+        value = std::min(hi, detail::below_wheel[small++]);
+        return;
+      }
+      while (bits == 0) {
+        if (++byte < seg.size()) {
+          bits = seg[byte];
+          continue;
+        }
+        if (seg_hi >= hi) {
+          value = hi;
+          return;
+        }
+        load(seg_hi);
+      }
+      value = first + 30 * byte + wheel[static_cast<size_t>(std::countr_zero(bits))];
+      bits &= bits - 1;
+    }
+
+    uint64_t value{0}, hi{0}, first{0}, seg_hi{0}, base_limit{0};
+    size_t byte{0}, small{detail::below_wheel.size()};
+    unsigned bits{0};
+    vector<uint8_t> seg;
+    std::shared_ptr<const vector<uint32_t>> base;
+  };
+
+  primes_view(uint64_t lo, uint64_t hi) : lo(lo), hi(std::min(hi, max_value)) {}
+
+  iterator begin() const { return {lo, hi}; }
+  std::default_sentinel_t end() const { return {}; }
+
+ private:
+  uint64_t lo, hi;
+};
+
+namespace views {
+
+struct primes_fn {
+  primes_view operator()(uint64_t lo) const { return {lo, max_value}; }
+  primes_view operator()(uint64_t lo, uint64_t hi) const { return {lo, hi}; }
+};
+inline constexpr primes_fn primes;
+
+}  // namespace views
+
+}  // namespace sieve
+
+int main() {
+  /************************************************************************************/
+  // 01_prime_sieve.cpp
+  {
+    vector nums = {4, 6, 8, 9, 10, 11, 13, 15, 17, 19, 23, 25};
+
+    auto flt = V::filter;
+    auto gt_10 = [](auto n) { return n > 10; };
+    auto is_prime = sieve::is_prime(0, 26);
+    auto prime_gt_10 = nums | flt(gt_10) | flt(is_prime) | V::take(3);
+    print("Ex01: First three prime numbers greater than 10: {}\n", prime_gt_10);
+
+    print("Ex01: views::primes(11) | take(3): {}\n",
+          sieve::views::primes(11) | V::take(3));
+    const uint64_t T = 1'000'000'000'000;
+    print("Ex01: primes in [1e12, 1e12 + 100): {}\n", sieve::views::primes(T, T + 100));
+    print("Ex01: primes_between(1e9, 1e9 + 100): {}\n",
+          sieve::primes_between(1'000'000'000, 1'000'000'100));
+    uint64_t sum = 0;
+    sieve::for_each_prime(0, 2'000'000, [&](uint64_t p) { sum += p; });
+    print("Ex01: sum of the primes below 2e6: {}\n", sum);
+    const uint64_t m61 = (uint64_t{1} << 61) - 1;
+    print("Ex01: miller_rabin 2^61-1 {} 2^61+1 {} 18446744073709551557 {}\n",
+          sieve::miller_rabin(m61), sieve::miller_rabin(m61 + 2),
+          sieve::miller_rabin(18446744073709551557u));
+  }
+
+  /************************************************************************************/
+  // 02_bench_prime_sieve.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const auto hw = std::max(1u, std::thread::hardware_concurrency());
+
+    // the trial division of 85_ch_15, widened so i * i cannot overflow
+    auto trial = [](int64_t n) {
+      if (n <= 1) return false;
+      for (int64_t i = 2; i * i <= n; i++)
+        if (n % i == 0) return false;
+      return true;
+    };
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      auto r = fn();
+      duration<double> elapsed = clock::now() - start;
+      return std::pair{r, elapsed.count()};
+    };
+
+    // pi(N) for N = 1e6 .. 1e10; the slow methods only where they finish in seconds
+    const std::array<uint64_t, 5> pi{78'498, 664'579, 5'761'455, 50'847'534,
+                                     455'052'511};
+    uint64_t N = 1'000'000;
+    for (auto expect : pi) {
+      print("Ex02: pi({:<11})", N);
+      bool ok = true;
+      if (N <= 1'000'000) {
+        auto [c, t] = time([&] { return R::count_if(V::iota(uint64_t{0}, N), trial); });
+        ok = ok && uint64_t(c) == expect;
+        print(" trial {:.4f}s", t);
+      }
+      if (N <= 10'000'000) {
+        auto [c, t] = time([&] {
+          return R::count_if(V::iota(uint64_t{0}, N), sieve::miller_rabin);
+        });
+        ok = ok && uint64_t(c) == expect;
+        print(" miller-rabin {:.4f}s", t);
+      }
+      if (N <= 1'000'000'000) {
+        auto [c, t] = time([&] { return sieve::count_primes(0, N, 1); });
+        ok = ok && c == expect;
+        print(" sieve x1 {:.4f}s", t);
+      }
+      auto [c, t] = time([&] { return sieve::count_primes(0, N, hw); });
+      print(" sieve x{} {:.4f}s = {} ok {}\n", hw, t, c, ok && c == expect);
+      N *= 10;
+    }
+
+    // filter a window of W consecutive integers at increasing magnitudes
+    const int64_t W = 100'000;
+    for (int64_t B : {1'000'000ll, 100'000'000ll, 10'000'000'000ll}) {
+      auto window = V::iota(B, B + W);
+      auto [a, t_trial] = time([&] { return R::distance(window | V::filter(trial)); });
+      auto [b, t_mr] = time([&] {
+        return R::distance(window | V::filter([](int64_t n) {
+                             return sieve::miller_rabin(static_cast<uint64_t>(n));
+                           }));
+      });
+      auto [c, t_table] = time([&] {
+        auto is_prime = sieve::is_prime(uint64_t(B), uint64_t(B + W));
+        return R::distance(window | V::filter(is_prime));
+      });
+      auto [d, t_view] =
+          time([&] { return R::distance(sieve::views::primes(B, B + W)); });
+      print("Ex02: [{:.0e}, +{}) trial {:.4f}s miller-rabin {:.4f}s", double(B), W,
+            t_trial, t_mr);
+      print(" is_prime filter {:.4f}s views::primes {:.4f}s ok {}\n", t_table, t_view,
+            a == b && b == c && c == d);
+    }
+
+    // batch: dense small values take the sieve, sparse 64-bit values Miller-Rabin
+    std::mt19937_64 gen{2112};
+    const size_t M = 2'000'000;
+    for (uint64_t range : {uint64_t{10'000'000}, uint64_t{1} << 62}) {
+      vector<uint64_t> xs(M);
+      R::generate(xs, [&] { return gen() % range; });
+      auto [seq, t_seq] = time([&] {
+        return xs | V::filter(sieve::miller_rabin) | R::to<vector>();
+      });
+      auto [par, t_par] =
+          time([&] { return sieve::select_primes(std::span<const uint64_t>(xs), hw); });
+      print("Ex02: {} values < {:.1e} filter(miller_rabin) {:.4f}s", M, double(range),
+            t_seq);
+      print(" select_primes x{} {:.4f}s ok {}\n", hw, t_par, seq == par);
+    }
+  }
+}
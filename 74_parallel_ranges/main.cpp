@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Parallel terminal operations for adaptor chains over contiguous sources.
+//
+// A filtered view is not random access, so it cannot be split after the fact. The
+// source is split instead: each thread applies the same adaptor closure (e.g.
+// V::filter(p) | V::transform(f)) to its own span of the source. This is only
+// equivalent to applying the chain to the whole source when the chain is
+// element-wise (filter/transform and friends); V::take/V::drop/V::chunk and other
+// positional adaptors belong after the parallel step.
+namespace par {
+
+template <typename Fn>
+void for_chunks(size_t n, unsigned n_threads, Fn fn) {
+  if (n_threads <= 1) return fn(0u, size_t{0}, n);
+  vector<std::jthread> pool;
+  for (unsigned t = 0; t < n_threads; ++t)
+    pool.emplace_back(fn, t, n * t / n_threads, n * (t + 1) / n_threads);
+}
+
+inline unsigned threads_for(size_t n, unsigned n_threads) {
+  if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+  return static_cast<unsigned>(std::clamp<size_t>(n / 16384, 1, n_threads));
+}
+
+template <R::contiguous_range Src>
+auto chunk(const Src &src, size_t b, size_t e) {
+  return std::span(R::data(src) + b, e - b);
+}
+
+// Every thread runs the chain over its chunk into a local buffer, reserved from the
+// selectivity of a short probe of the chunk. The output is then allocated once at
+// its exact size and every thread moves its buffer to its prefix-summed offset, so
+// the result is in source order.
+template <template <typename...> typename C, R::contiguous_range Src, typename Chain>
+auto to(const Src &src, Chain chain, unsigned n_threads = 0) {
+  using T = R::range_value_t<decltype(chunk(src, 0, 0) | chain)>;
+  const auto n = R::size(src);
+  n_threads = threads_for(n, n_threads);
+
+  vector<vector<T>> parts(n_threads);
+  for_chunks(n, n_threads, [&](unsigned t, size_t b, size_t e) {
+    const auto probe = std::min<size_t>(e - b, 4096);
+    if (probe == 0) return;
+    const auto hits = R::distance(chunk(src, b, b + probe) | chain);
+    parts[t].reserve(size_t(double(hits + 1) / double(probe) * double(e - b) * 1.1));
+    for (auto &&x : chunk(src, b, e) | chain) parts[t].emplace_back(x);
+  });
+
+  vector<size_t> offset(n_threads + 1);
+  for (unsigned t = 0; t < n_threads; ++t) offset[t + 1] = offset[t] + parts[t].size();
+
+  C<T> out(offset.back());
+  for_chunks(n_threads, n_threads, [&](unsigned t, size_t, size_t) {
+    R::move(parts[t], out.begin() + offset[t]);
+    parts[t] = {};
+  });
+  return out;
+}
+
+template <R::contiguous_range Src, typename Chain, typename Pred>
+size_t count_if(const Src &src, Chain chain, Pred pred, unsigned n_threads = 0) {
+  const auto n = R::size(src);
+  n_threads = threads_for(n, n_threads);
+  struct alignas(64) Part {
+    size_t n{0};
+  };
+  vector<Part> parts(n_threads);
+  for_chunks(n, n_threads, [&](unsigned t, size_t b, size_t e) {
+    auto c = R::count_if(chunk(src, b, e) | chain, pred);
+    parts[t].n = static_cast<size_t>(c);
+  });
+  size_t total = 0;
+  for (auto p : parts) total += p.n;
+  return total;
+}
+
+// op must be associative; partial results are combined in chunk order, so it need
+// not be commutative
+template <R::contiguous_range Src, typename Chain, typename T,
+          typename Op = std::plus<>>
+T reduce(const Src &src, Chain chain, T init, Op op = {}, unsigned n_threads = 0) {
+  const auto n = R::size(src);
+  n_threads = threads_for(n, n_threads);
+  vector<std::optional<T>> parts(n_threads);
+  for_chunks(n, n_threads, [&](unsigned t, size_t b, size_t e) {
+    for (auto &&x : chunk(src, b, e) | chain)
+      parts[t] = parts[t] ? op(std::move(*parts[t]), x) : T(x);
+  });
+  for (auto &p : parts)
+    if (p) init = op(std::move(init), std::move(*p));
+  return init;
+}
+
+}  // namespace par
+
+int main() {
+  /************************************************************************************/
+  // 01_parallel_ranges.cpp
+  {
+    auto is_prime = [](auto n) {
+      if (n <= 1) return false;
+      for (auto i = 2; i * i <= n; i++)
+        if (n % i == 0) return false;
+      return true;
+    };
+
+    vector nums = {4, 6, 8, 9, 10, 11, 13, 15, 17, 19, 23, 25};
+
+    auto flt = V::filter;
+    auto gt_10 = [](auto n) { return n > 10; };
+    auto chain = flt(gt_10) | flt(is_prime);
+
+    auto primes = par::to<vector>(nums, chain, 4);
+    print("Ex01: First three prime numbers greater than 10: {}\n", primes | V::take(3));
+    auto below_20 = [](int n) { return n < 20; };
+    print("Ex01: count below 20 {} sum {}\n", par::count_if(nums, chain, below_20),
+          par::reduce(nums, chain, 0));
+  }
+
+  /************************************************************************************/
+  // 02_bench_parallel_ranges.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const int N = 100'000'000;
+    const auto nums = V::iota(0, N) | R::to<vector>();
+    const auto hw = std::max(1u, std::thread::hardware_concurrency());
+
+    auto gt_10 = [](int n) { return n > 10; };
+    auto sq_mod = [](int n) { return int64_t(n) * n % 1'000'003; };
+    auto chain = V::filter(gt_10) | V::filter([](int n) { return n % 3 == 0; }) |
+                 V::transform(sq_mod);
+
+    auto time = [](auto fn) {
+      auto start = clock::now();
+      auto r = fn();
+      duration<double> elapsed = clock::now() - start;
+      return std::pair{r, elapsed.count()};
+    };
+
+    auto [seq, t_seq] = time([&] { return nums | chain | R::to<vector>(); });
+    auto [seq_sum, t_seq_sum] =
+        time([&] { return R::fold_left(nums | chain, int64_t{0}, std::plus<>()); });
+    print("Ex02: sequential R::to {:.4f}s fold_left {:.4f}s ({} elems)\n", t_seq,
+          t_seq_sum, seq.size());
+
+    auto even = [](int64_t x) { return x % 2 == 0; };
+    const auto seq_even = R::count_if(seq, even);
+
+    for (unsigned t : {1u, 2u, 4u, hw}) {
+      auto [out, t_to] = time([&] { return par::to<vector>(nums, chain, t); });
+      auto [sum, t_red] =
+          time([&] { return par::reduce(nums, chain, int64_t{0}, std::plus<>(), t); });
+      auto [cnt, t_cnt] = time([&] { return par::count_if(nums, chain, even, t); });
+      print("Ex02: threads {:2} par::to {:.4f}s reduce {:.4f}s count_if {:.4f}s", t,
+            t_to, t_red, t_cnt);
+      print(" ok {}\n", out == seq && sum == seq_sum && cnt == size_t(seq_even));
+    }
+  }
+}
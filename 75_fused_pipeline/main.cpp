@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Block-at-a-time pipelines. A chain like
+//     fused::from(data) | fused::filter(p) | fused::transform(f) | fused::to_vector()
+// is compiled into one loop nest over blocks of `block` elements. Inside a block a
+// filter only writes a selection vector (indices of the surviving rows, branch free)
+// and a transform runs as a plain loop over a dense array, which the compiler
+// vectorizes; a transform after a filter gathers through the selection vector and
+// hands a dense block to the next stage. Nothing is allocated except the output.
+namespace fused {
+
+inline constexpr size_t block = 2048;
+using sel_t = uint16_t;
+inline constexpr const sel_t *dense = nullptr;
+
+template <typename F>
+struct filter_stage {
+  F pred;
+};
+template <typename F>
+struct transform_stage {
+  F fn;
+};
+
+template <typename F>
+filter_stage<F> filter(F f) {
+  return {f};
+}
+template <typename F>
+transform_stage<F> transform(F f) {
+  return {f};
+}
+
+// contiguous source: blocks point straight into the caller's memory
+template <typename T>
+struct span_source {
+  using value_type = T;
+  std::span<const T> data;
+  size_t size() const { return data.size(); }
+  const T *block_at(size_t off, size_t, T *) const { return data.data() + off; }
+};
+
+// counting source: blocks are generated into a stack buffer
+template <typename T>
+struct iota_source {
+  using value_type = T;
+  T first, last;
+  size_t size() const { return static_cast<size_t>(last - first); }
+  const T *block_at(size_t off, size_t n, T *buf) const {
+    for (size_t i = 0; i < n; ++i) buf[i] = first + static_cast<T>(off + i);
+    return buf;
+  }
+};
+
+template <typename Src, typename... Stages>
+struct pipeline {
+  Src src;
+  std::tuple<Stages...> stages;
+};
+
+template <typename T>
+pipeline<span_source<T>> from(std::span<const T> s) {
+  return {{s}, {}};
+}
+template <typename T>
+pipeline<span_source<T>> from(const vector<T> &v) {
+  return {{std::span<const T>(v)}, {}};
+}
+template <typename T>
+pipeline<iota_source<T>> iota(T first, T last) {
+  return {{first, last}, {}};
+}
+
+template <typename Src, typename... Stages, typename F>
+pipeline<Src, Stages..., filter_stage<F>> operator|(pipeline<Src, Stages...> p,
+                                                    filter_stage<F> s) {
+  return {p.src, std::tuple_cat(p.stages, std::tuple{s})};
+}
+template <typename Src, typename... Stages, typename F>
+pipeline<Src, Stages..., transform_stage<F>> operator|(pipeline<Src, Stages...> p,
+                                                       transform_stage<F> s) {
+  return {p.src, std::tuple_cat(p.stages, std::tuple{s})};
+}
+
+template <typename>
+struct is_filter : std::false_type {};
+template <typename F>
+struct is_filter<filter_stage<F>> : std::true_type {};
+
+// push one block through stages I.. and hand the survivors to sink(vals, sel, n).
+// sel == dense (nullptr) means the survivors are rows 0..n-1 of vals.
+template <size_t I, typename Val, typename Tuple, typename Sink>
+void run_block(const Val *vals, const sel_t *sel, size_t n, Tuple &stages, Sink &sink) {
+  if constexpr (I == std::tuple_size_v<Tuple>) {
+    sink(vals, sel, n);
+  } else {
+    auto &stage = std::get<I>(stages);
+    if constexpr (is_filter<std::remove_cvref_t<decltype(stage)>>::value) {
+      std::array<sel_t, block> out;
+      size_t k = 0;
+      if (sel)
+        for (size_t j = 0; j < n; ++j) {
+          out[k] = sel[j];
+          k += static_cast<bool>(stage.pred(vals[sel[j]]));
+        }
+      else
+        for (size_t i = 0; i < n; ++i) {
+          out[k] = static_cast<sel_t>(i);
+          k += static_cast<bool>(stage.pred(vals[i]));
+        }
+      run_block<I + 1>(vals, out.data(), k, stages, sink);
+    } else {
+      using Out = std::remove_cvref_t<std::invoke_result_t<decltype(stage.fn), Val>>;
+      std::array<Out, block> out;
+      if (sel)
+        for (size_t j = 0; j < n; ++j) out[j] = stage.fn(vals[sel[j]]);
+      else
+        for (size_t i = 0; i < n; ++i) out[i] = stage.fn(vals[i]);
+      run_block<I + 1>(out.data(), dense, n, stages, sink);
+    }
+  }
+}
+
+template <typename Src, typename... Stages, typename Sink>
+void run(pipeline<Src, Stages...> &p, Sink &sink) {
+  using T = typename Src::value_type;
+  std::array<T, block> buf;
+  const auto total = p.src.size();
+  for (size_t off = 0; off < total; off += block) {
+    const auto n = std::min(block, total - off);
+    sink.begin_block(off, n, total);
+    run_block<0>(p.src.block_at(off, n, buf.data()), dense, n, p.stages, sink);
+  }
+}
+
+struct to_vector_t {};
+struct count_t {};
+inline to_vector_t to_vector() { return {}; }
+inline count_t count() { return {}; }
+
+// value type after the last transform
+template <typename Val, typename... Stages>
+struct output_of {
+  using type = Val;
+};
+template <typename Val, typename F, typename... Rest>
+struct output_of<Val, filter_stage<F>, Rest...> : output_of<Val, Rest...> {};
+template <typename Val, typename F, typename... Rest>
+struct output_of<Val, transform_stage<F>, Rest...>
+    : output_of<std::remove_cvref_t<std::invoke_result_t<F &, const Val &>>, Rest...> {
+};
+
+// Capacity is reserved from the selectivity seen so far (first block, then again
+// whenever it runs out), so the output grows in a few steps instead of doubling.
+template <typename Src, typename... Stages>
+auto operator|(pipeline<Src, Stages...> p, to_vector_t) {
+  using Out = typename output_of<typename Src::value_type, Stages...>::type;
+  struct {
+    vector<Out> out;
+    void begin_block(size_t off, size_t n, size_t total) {
+      if (off == 0) return;
+      if (out.size() + n > out.capacity()) {
+        const double rate = double(out.size() + 1) / double(off);
+        out.reserve(out.size() + size_t(rate * double(total - off) * 1.1) + n);
+      }
+    }
+    void operator()(const Out *vals, const sel_t *sel, size_t n) {
+      if (sel)
+        for (size_t j = 0; j < n; ++j) out.push_back(vals[sel[j]]);
+      else
+        out.insert(out.end(), vals, vals + n);
+    }
+  } sink;
+  sink.out.reserve(std::min(block, p.src.size()));
+  run(p, sink);
+  return std::move(sink.out);
+}
+
+template <typename Src, typename... Stages>
+size_t operator|(pipeline<Src, Stages...> p, count_t) {
+  struct {
+    size_t n{0};
+    void begin_block(size_t, size_t, size_t) {}
+    void operator()(const void *, const sel_t *, size_t k) { n += k; }
+  } sink;
+  run(p, sink);
+  return sink.n;
+}
+
+}  // namespace fused
+
+int main() {
+  /************************************************************************************/
+  // 01_fused_pipeline.cpp
+  {
+    vector data = {5, 2, 9, 1, 5, 6, 8, 7, 3, 4};
+
+    auto is_even = [](auto x) { return x % 2 == 0; };
+    auto neg = [](auto x) { return -x; };
+    auto even = fused::from(data) | fused::filter(is_even) | fused::transform(neg) |
+                fused::to_vector();
+    R::sort(even);
+    print("Ex01: sorted even: {}\n", even);
+
+    double time_step_delta = 0.01;
+    auto scale = [time_step_delta](auto x) { return x * time_step_delta; };
+    auto time_steps = fused::iota(0, 20) | fused::transform(scale) | fused::to_vector();
+    print("Ex01: time steps: {}\n", time_steps);
+  }
+
+  /************************************************************************************/
+  // 02_bench_fused_pipeline.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const int N = 20'000'000;
+    vector<int> data(N);
+    std::mt19937 gen{2112};
+    R::generate(data, [&] { return int(gen() % 1000); });
+
+    auto time = [](const char *name, auto fn) {
+      auto start = clock::now();
+      auto r = fn();
+      duration<double> elapsed = clock::now() - start;
+      print("Ex02: {:38} {:.4f}s", name, elapsed.count());
+      return r;
+    };
+
+    auto is_even = [](int x) { return x % 2 == 0; };
+    auto neg = [](int x) { return -x; };
+    auto a = time("views filter|transform|to<vector>", [&] {
+      return data | V::filter(is_even) | V::transform(neg) | R::to<vector>();
+    });
+    print("\n");
+    auto b = time("fused filter|transform|to_vector", [&] {
+      return fused::from(data) | fused::filter(is_even) | fused::transform(neg) |
+             fused::to_vector();
+    });
+    print(" same {}\n", a == b);
+
+    auto scale = [](int x) { return x * 0.01; };
+    auto c = time("views iota|transform|to<vector>", [&] {
+      return V::iota(0, N) | V::transform(scale) | R::to<vector>();
+    });
+    print("\n");
+    auto d = time("fused iota|transform|to_vector", [&] {
+      return fused::iota(0, N) | fused::transform(scale) | fused::to_vector();
+    });
+    print(" same {}\n", c == d);
+
+    auto gt_10 = [](int n) { return n > 10; };
+    auto is_prime = [](int n) {
+      if (n <= 1) return false;
+      for (auto i = 2; i * i <= n; i++)
+        if (n % i == 0) return false;
+      return true;
+    };
+    auto e = time("views filter|filter|distance", [&] {
+      return size_t(R::distance(data | V::filter(gt_10) | V::filter(is_prime)));
+    });
+    print("\n");
+    auto f = time("fused filter|filter|count", [&] {
+      return fused::from(data) | fused::filter(gt_10) | fused::filter(is_prime) |
+             fused::count();
+    });
+    print(" same {}\n", e == f);
+  }
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Fenwick (binary indexed) tree of counts over [0, n): prefix sums and "find the k-th
+// present slot" both in O(log n)
+class Fenwick {
+ public:
+  explicit Fenwick(size_t n)
+      : tree(n + 1), top(std::bit_floor(std::max<size_t>(n, 1))) {}
+
+  // every slot present once, built in O(n)
+  static Fenwick all_ones(size_t n) {
+    Fenwick f(n);
+    for (size_t i = 1; i <= n; ++i) {
+      f.tree[i] += 1;
+      if (auto j = i + (i & -i); j <= n) f.tree[j] += f.tree[i];
+    }
+    return f;
+  }
+
+  void add(size_t i, int delta) {
+    for (++i; i < tree.size(); i += i & -i) tree[i] += delta;
+  }
+
+  // count of present slots in [0, i)
+  int prefix(size_t i) const {
+    int s = 0;
+    for (; i > 0; i -= i & -i) s += tree[i];
+    return s;
+  }
+
+  // index of the k-th (0-based) present slot
+  size_t find_kth(int k) const {
+    size_t pos = 0;
+    for (auto step = top; step > 0; step >>= 1)
+      if (pos + step < tree.size() && tree[pos + step] <= k) {
+        pos += step;
+        k -= tree[pos];
+      }
+    return pos;
+  }
+
+ private:
+  vector<int> tree;
+  size_t top;
+};
+
+// n! for n <= 20, the largest that fits a uint64_t
+constexpr uint64_t factorial(size_t n) {
+  uint64_t f = 1;
+  for (size_t i = 2; i <= n; ++i) f *= i;
+  return f;
+}
+
+// k-th permutation (0-based, lexicographic) of sorted distinct items. k is written in
+// the factorial number system; digit i picks the digit-th unused item, which the
+// Fenwick tree finds in O(log n).
+template <typename T>
+vector<T> unrank_permutation(std::span<const T> sorted, uint64_t k) {
+  const auto n = sorted.size();
+  auto unused = Fenwick::all_ones(n);
+  vector<T> out;
+  out.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    const auto f = factorial(n - 1 - i);
+    const auto slot = unused.find_kth(static_cast<int>(k / f));
+    k %= f;
+    unused.add(slot, -1);
+    out.push_back(sorted[slot]);
+  }
+  return out;
+}
+
+// lexicographic rank of perm among the permutations of sorted (the inverse of
+// unrank_permutation): digit i is how many unused items are smaller than perm[i]
+template <typename T>
+uint64_t rank_permutation(std::span<const T> sorted, std::span<const T> perm) {
+  const auto n = sorted.size();
+  auto unused = Fenwick::all_ones(n);
+  uint64_t k = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const auto slot =
+        static_cast<size_t>(R::lower_bound(sorted, perm[i]) - sorted.begin());
+    k += uint64_t(unused.prefix(slot)) * factorial(n - 1 - i);
+    unused.add(slot, -1);
+  }
+  return k;
+}
+
+// Splits [0, n!) into one contiguous block of ranks per thread. Each thread unranks
+// its first permutation and walks the rest of its block with next_permutation, so
+// the union is every permutation exactly once. fn(perm, thread) is called per
+// permutation and must be safe to call concurrently.
+template <typename T, typename Fn>
+void par_for_each_permutation(std::span<const T> sorted, unsigned n_threads, Fn fn) {
+  const auto total = factorial(sorted.size());
+  n_threads = static_cast<unsigned>(std::clamp<uint64_t>(total, 1, n_threads));
+  vector<std::jthread> pool;
+  for (unsigned t = 0; t < n_threads; ++t)
+    pool.emplace_back([&, t] {
+      // 20! * t overflows uint64, so spread the remainder over the first blocks
+      auto bound = [&](uint64_t i) {
+        return total / n_threads * i + std::min<uint64_t>(i, total % n_threads);
+      };
+      const auto b = bound(t), e = bound(t + 1);
+      auto perm = unrank_permutation(sorted, b);
+      for (auto k = b; k < e; ++k) {
+        fn(std::as_const(perm), t);
+        R::next_permutation(perm);
+      }
+    });
+}
+
+int main() {
+  /************************************************************************************/
+  // 01_permutation_rank.cpp
+  {
+    const vector d{1, 2, 3};
+    std::span<const int> items(d);
+
+    for (uint64_t k = 0; k < factorial(d.size()); ++k) {
+      auto p = unrank_permutation(items, k);
+      auto r = rank_permutation(items, std::span<const int>(p));
+      print("Ex01: {} -> {} -> rank {}\n", k, p, r);
+    }
+
+    const vector letters{'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j'};
+    auto p = unrank_permutation(std::span<const char>(letters), 1'000'000);
+    print("Ex01: 1'000'000th permutation of a..j: {}\n", p | R::to<std::string>());
+  }
+
+  /************************************************************************************/
+  // 02_bench_permutation_rank.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const auto hw = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t n : {10uz, 11uz, 12uz}) {
+      vector<uint8_t> items(n);
+      std::iota(items.begin(), items.end(), uint8_t{0});
+      std::span<const uint8_t> sorted(items);
+
+      // checksum that depends on every permutation's position-weighted contents
+      auto weigh = [](std::span<const uint8_t> p) {
+        uint64_t w = 0;
+        for (size_t i = 0; i < p.size(); ++i) w += p[i] * (i + 1);
+        return w;
+      };
+
+      auto d = items;
+      uint64_t seq_sum = 0;
+      auto start = clock::now();
+      do {
+        seq_sum += weigh(d);
+      } while (R::next_permutation(d).found);
+      duration<double> t_seq = clock::now() - start;
+      print("Ex02: n={:2} {:>10} perms next_permutation {:.4f}s\n", n, factorial(n),
+            t_seq.count());
+
+      for (unsigned t : {2u, 4u, hw}) {
+        struct alignas(64) Sum {
+          uint64_t v{0};
+        };
+        vector<Sum> sums(t);
+        start = clock::now();
+        par_for_each_permutation(sorted, t, [&](const auto &p, unsigned th) {
+          sums[th].v += weigh(p);
+        });
+        duration<double> t_par = clock::now() - start;
+        uint64_t par_sum = 0;
+        for (auto s : sums) par_sum += s.v;
+        print("Ex02:      par threads {:2} {:.4f}s ok {}\n", t, t_par.count(),
+              par_sum == seq_sum);
+      }
+
+      // random access: unrank then rank back a batch of random indices
+      std::mt19937_64 gen{2112};
+      const size_t Q = 1'000'000;
+      bool ok = true;
+      start = clock::now();
+      for (size_t q = 0; q < Q; ++q) {
+        const auto k = gen() % factorial(n);
+        auto p = unrank_permutation(sorted, k);
+        ok = ok && rank_permutation(sorted, std::span<const uint8_t>(p)) == k;
+      }
+      duration<double> t_rand = clock::now() - start;
+      print("Ex02:      {} random unrank+rank {:.4f}s ok {}\n", Q, t_rand.count(), ok);
+    }
+  }
+}
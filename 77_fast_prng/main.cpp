@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <numeric>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+__extension__ using u128 = unsigned __int128;
+
+// seed expander recommended for the xoshiro family
+inline uint64_t splitmix64(uint64_t &x) {
+  uint64_t z = (x += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+// xoshiro256** - 32 bytes of state, a handful of shifts/xors per output.
+// jump() advances 2^128 steps, so stream t = seed + t jumps never overlap.
+class Xoshiro256 {
+ public:
+  using result_type = uint64_t;
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+  explicit Xoshiro256(uint64_t seed = 2112) {
+    for (auto &x : s) x = splitmix64(seed);
+  }
+
+  result_type operator()() {
+    const auto out = std::rotl(s[1] * 5, 7) * 9;
+    const auto t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = std::rotl(s[3], 45);
+    return out;
+  }
+
+  void jump() {
+    constexpr std::array<uint64_t, 4> J = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+                                           0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+    std::array<uint64_t, 4> acc{};
+    for (auto j : J)
+      for (int b = 0; b < 64; ++b) {
+        if (j & (uint64_t{1} << b))
+          for (size_t i = 0; i < 4; ++i) acc[i] ^= s[i];
+        (*this)();
+      }
+    s = acc;
+  }
+
+  // independent generator for thread t
+  Xoshiro256 stream(unsigned t) const {
+    auto g = *this;
+    for (unsigned i = 0; i <= t; ++i) g.jump();
+    return g;
+  }
+
+  // Bulk fill from four interleaved lanes (this generator jumped 0..3 times). With
+  // AVX2 the lanes live in ymm registers: *5 and *9 are shift+add, so no 64 bit
+  // vector multiply is needed. The scalar path produces the same sequence.
+  void fill(std::span<uint64_t> out) {
+    std::array<Xoshiro256, 4> lane = {*this, stream(0), stream(1), stream(2)};
+    size_t i = 0;
+#ifdef __AVX2__
+    __m256i v[4];
+    for (size_t w = 0; w < 4; ++w)
+      v[w] = _mm256_setr_epi64x(lane[0].s[w], lane[1].s[w], lane[2].s[w], lane[3].s[w]);
+    auto rotl = [](__m256i x, int k) {
+      return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+    };
+    for (; i + 4 <= out.size(); i += 4) {
+      const auto m5 = _mm256_add_epi64(_mm256_slli_epi64(v[1], 2), v[1]);
+      const auto r = rotl(m5, 7);
+      const auto res = _mm256_add_epi64(_mm256_slli_epi64(r, 3), r);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(&out[i]), res);
+      const auto t = _mm256_slli_epi64(v[1], 17);
+      v[2] = _mm256_xor_si256(v[2], v[0]);
+      v[3] = _mm256_xor_si256(v[3], v[1]);
+      v[1] = _mm256_xor_si256(v[1], v[2]);
+      v[0] = _mm256_xor_si256(v[0], v[3]);
+      v[2] = _mm256_xor_si256(v[2], t);
+      v[3] = rotl(v[3], 45);
+    }
+    for (size_t w = 0; w < 4; ++w) {
+      alignas(32) uint64_t tmp[4];
+      _mm256_store_si256(reinterpret_cast<__m256i *>(tmp), v[w]);
+      for (size_t l = 0; l < 4; ++l) lane[l].s[w] = tmp[l];
+    }
+#endif
+    for (; i + 4 <= out.size(); i += 4)
+      for (size_t l = 0; l < 4; ++l) out[i + l] = lane[l]();
+    for (size_t l = 0; i < out.size(); ++i, ++l) out[i] = lane[l]();
+    *this = lane[0];
+  }
+
+ private:
+  std::array<uint64_t, 4> s;
+};
+
+// PCG64 (XSL-RR 128/64): 128 bit LCG state, permuted 64 bit output.
+// advance(n) jumps n steps in O(log n), giving disjoint per-thread blocks.
+class Pcg64 {
+ public:
+  using result_type = uint64_t;
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+  explicit Pcg64(uint64_t seed = 2112, uint64_t seq = 54) {
+    inc = (u128(seq) << 1) | 1;
+    (*this)();
+    state += seed;
+    (*this)();
+  }
+
+  result_type operator()() {
+    state = state * mult + inc;
+    const auto x = uint64_t(state >> 64) ^ uint64_t(state);
+    return std::rotr(x, int(state >> 122));
+  }
+
+  void advance(u128 delta) {
+    u128 acc_mult = 1, acc_plus = 0, cur_mult = mult, cur_plus = inc;
+    for (; delta > 0; delta >>= 1) {
+      if (delta & 1) {
+        acc_mult *= cur_mult;
+        acc_plus = acc_plus * cur_mult + cur_plus;
+      }
+      cur_plus = (cur_mult + 1) * cur_plus;
+      cur_mult *= cur_mult;
+    }
+    state = acc_mult * state + acc_plus;
+  }
+
+  Pcg64 stream(unsigned t) const {
+    auto g = *this;
+    g.advance(u128(t + 1) << 96);
+    return g;
+  }
+
+  void fill(std::span<uint64_t> out) {
+    for (auto &x : out) x = (*this)();
+  }
+
+ private:
+  static constexpr u128 mult =
+      (u128(2549297995355413924ull) << 64) + 4865540595714422341ull;
+  u128 state{0}, inc;
+};
+
+// wyrand: a Weyl sequence mixed by one 64x64->128 multiply. 8 bytes of state;
+// jumping n steps is a single add.
+class WyRand {
+ public:
+  using result_type = uint64_t;
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+  explicit WyRand(uint64_t seed = 2112) : s(seed) {}
+
+  result_type operator()() { return mix(s += inc); }
+
+  void advance(uint64_t n) { s += n * inc; }
+
+  WyRand stream(unsigned t) const {
+    auto g = *this;
+    g.advance(uint64_t(t + 1) << 48);
+    return g;
+  }
+
+  // the Weyl counter is known ahead, so lanes are independent and unroll freely
+  void fill(std::span<uint64_t> out) {
+    const auto base = s;
+    for (size_t i = 0; i < out.size(); ++i) out[i] = mix(base + (i + 1) * inc);
+    s = base + out.size() * inc;
+  }
+
+ private:
+  static uint64_t mix(uint64_t x) {
+    const u128 m = u128(x) * (x ^ 0xe7037ed1a0b428db);
+    return uint64_t(m >> 64) ^ uint64_t(m);
+  }
+  static constexpr uint64_t inc = 0xa0761d6478bd642f;
+  uint64_t s;
+};
+
+// uniform integer in [0, range) with Lemire's multiply-shift, rejecting the bias
+template <typename G>
+uint64_t bounded(G &g, uint64_t range) {
+  u128 m = u128(g()) * range;
+  if (uint64_t(m) < range) {
+    const auto threshold = -range % range;
+    while (uint64_t(m) < threshold) m = u128(g()) * range;
+  }
+  return uint64_t(m >> 64);
+}
+
+template <typename T, typename G>
+void fisher_yates(std::span<T> data, G &g) {
+  for (auto i = data.size(); i > 1; --i) std::swap(data[i - 1], data[bounded(g, i)]);
+}
+
+// Parallel Rao-Sandelius shuffle: every element is sent to one of B buckets chosen
+// uniformly at random (per-thread counts, prefix sums and a scatter, like a radix
+// pass), then every bucket is Fisher-Yates shuffled by a worker. Uniform random
+// bucket labels followed by uniform shuffles of each bucket give a uniform
+// permutation of the whole array.
+template <typename T, typename G = Xoshiro256>
+void par_shuffle(std::span<T> data, unsigned n_threads, G seed_gen = G{}) {
+  const auto n = data.size();
+  n_threads = static_cast<unsigned>(std::clamp<size_t>(n / 65536, 1, n_threads));
+  if (n_threads == 1) return fisher_yates(data, seed_gen);
+
+  const size_t B = std::min<size_t>(256, std::bit_ceil(size_t{4} * n_threads));
+  vector<uint8_t> label(n);
+  vector<vector<size_t>> counts(n_threads, vector<size_t>(B));
+  auto chunk = [&](unsigned t) {
+    return std::pair{n * t / n_threads, n * (t + 1) / n_threads};
+  };
+  auto run = [&](auto fn) {
+    vector<std::jthread> pool;
+    for (unsigned t = 0; t < n_threads; ++t) pool.emplace_back(fn, t);
+  };
+
+  run([&](unsigned t) {
+    auto g = seed_gen.stream(t);
+    auto [b, e] = chunk(t);
+    for (auto i = b; i < e; ++i) ++counts[t][label[i] = uint8_t(g() & (B - 1))];
+  });
+
+  vector<size_t> starts(B + 1);
+  size_t sum = 0;
+  for (size_t k = 0; k < B; ++k) {
+    starts[k] = sum;
+    for (unsigned t = 0; t < n_threads; ++t) sum += std::exchange(counts[t][k], sum);
+  }
+  starts[B] = n;
+
+  vector<T> buffer(n);
+  run([&](unsigned t) {
+    auto [b, e] = chunk(t);
+    for (auto i = b; i < e; ++i) buffer[counts[t][label[i]]++] = std::move(data[i]);
+  });
+
+  std::atomic<size_t> next{0};
+  run([&](unsigned t) {
+    auto g = seed_gen.stream(n_threads + t);
+    for (auto k = next++; k < B; k = next++) {
+      auto bucket = std::span(buffer).subspan(starts[k], starts[k + 1] - starts[k]);
+      fisher_yates(bucket, g);
+      R::move(bucket, data.begin() + starts[k]);
+    }
+  });
+}
+
+int main() {
+  /************************************************************************************/
+  // 01_fast_prng.cpp
+  {
+    Xoshiro256 xo{42};
+    Pcg64 pcg{42};
+    WyRand wy{42};
+    auto first3 = [](auto &g) {
+      return V::iota(0, 3) | V::transform([&](int) { return g(); });
+    };
+    print("Ex01: xoshiro256** {::x}\n", first3(xo));
+    print("Ex01: pcg64        {::x}\n", first3(pcg));
+    print("Ex01: wyrand       {::x}\n", first3(wy));
+
+    // drop-in for the 86_ch_14 shuffle, any UniformRandomBitGenerator works
+    vector n{1, 2, 3, 4, 5};
+    for (auto i : V::iota(1, 4)) {
+      R::shuffle(n, wy);
+      print("Ex01: {}: {}\n", i, n);
+    }
+
+    // bulk fill and the one-at-a-time calls give the same stream
+    Xoshiro256 a{7}, b{7};
+    vector<uint64_t> bulk(11);
+    a.fill(bulk);
+    auto l0 = b, l1 = b.stream(0), l2 = b.stream(1), l3 = b.stream(2);
+    std::array<Xoshiro256 *, 4> lanes = {&l0, &l1, &l2, &l3};
+    bool same = true;
+    for (size_t i = 0; i < bulk.size(); ++i)
+      same = same && bulk[i] == (*lanes[i % 4])();
+    print("Ex01: fill matches scalar lanes: {}\n", same);
+  }
+
+  /************************************************************************************/
+  // 02_bench_fill_shuffle.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    vector<uint64_t> buf(8 * 1024 * 1024);  // 64 MB
+    const double gb = double(buf.size() * sizeof(uint64_t)) / 1e9;
+
+    auto fill = [&](const char *name, auto fn) {
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      print("Ex02: fill {:22} {:6.2f} GB/s  ({:x})\n", name, gb / elapsed.count(),
+            buf[12345]);
+    };
+
+    std::mt19937_64 mt{2112};
+    Xoshiro256 xo;
+    Pcg64 pcg;
+    WyRand wy;
+    fill("mt19937_64", [&] { R::generate(buf, mt); });
+    fill("xoshiro256** scalar", [&] { R::generate(buf, xo); });
+    fill("xoshiro256** fill", [&] { xo.fill(buf); });
+    fill("pcg64", [&] { pcg.fill(buf); });
+    fill("wyrand", [&] { wy.fill(buf); });
+
+    const auto hw = std::max(1u, std::thread::hardware_concurrency());
+    const size_t N = 20'000'000;
+    vector<uint32_t> v(N);
+
+    auto shuffle = [&](const char *name, auto fn) {
+      std::iota(v.begin(), v.end(), 0u);
+      auto start = clock::now();
+      fn();
+      duration<double> elapsed = clock::now() - start;
+      const auto sum = std::accumulate(v.begin(), v.end(), uint64_t{0});
+      print("Ex02: shuffle {:24} {:.4f}s  perm ok {}\n", name, elapsed.count(),
+            sum == uint64_t(N) * (N - 1) / 2);
+    };
+    shuffle("R::shuffle mt19937", [&] {
+      std::mt19937 gen{2112};
+      R::shuffle(v, gen);
+    });
+    shuffle("fisher_yates wyrand", [&] { fisher_yates(std::span(v), wy); });
+    for (unsigned t : {2u, 4u, hw})
+      shuffle(std::format("par_shuffle t={}", t).c_str(),
+              [&] { par_shuffle(std::span(v), t, Xoshiro256{t}); });
+  }
+}
@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <print>
+#include <queue>
+#include <random>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// Implicit D-ary heap in a vector, same ordering as std::priority_queue: top() is the
+// greatest element by cmp. With D = 4 or 8 the children of a node share one or two
+// cache lines, the tree is half or a third as deep, and pop does fewer, cheaper
+// levels of sift-down.
+template <typename T, size_t D = 4, typename Cmp = std::less<T>>
+class DaryHeap {
+  static_assert(D >= 2);
+
+ public:
+  explicit DaryHeap(Cmp cmp = {}) : cmp(cmp) {}
+
+  const T &top() const { return data.front(); }
+  size_t size() const { return data.size(); }
+  bool empty() const { return data.empty(); }
+  void reserve(size_t n) { data.reserve(n); }
+
+  void push(T x) {
+    data.push_back(std::move(x));
+    sift_up(data.size() - 1);
+  }
+
+  void pop() {
+    data.front() = std::move(data.back());
+    data.pop_back();
+    if (!data.empty()) sift_down(0);
+  }
+
+  // Append a batch. k single sift-ups cost about k*log(n+k) moves while rebuilding
+  // with Floyd's bottom-up heapify is O(n+k), so rebuild when the batch is big.
+  template <R::input_range Rng>
+  void push_range(Rng &&rng) {
+    const auto old = data.size();
+    R::copy(rng, std::back_inserter(data));
+    const auto k = data.size() - old;
+    if (k * std::bit_width(data.size()) > data.size()) {
+      for (auto i = parent(data.size() - 1) + 1; i-- > 0;) sift_down(i);
+    } else {
+      for (auto i = old; i < data.size(); ++i) sift_up(i);
+    }
+  }
+
+ private:
+  static size_t parent(size_t i) { return (i - 1) / D; }
+
+  void sift_up(size_t i) {
+    T x = std::move(data[i]);
+    while (i > 0 && cmp(data[parent(i)], x)) {
+      data[i] = std::move(data[parent(i)]);
+      i = parent(i);
+    }
+    data[i] = std::move(x);
+  }
+
+  void sift_down(size_t i) {
+    const auto n = data.size();
+    T x = std::move(data[i]);
+    for (;;) {
+      const auto first = D * i + 1;
+      if (first >= n) break;
+      const auto last = std::min(first + D, n);
+      auto best = first;
+      for (auto c = first + 1; c < last; ++c)
+        if (cmp(data[best], data[c])) best = c;
+      if (!cmp(x, data[best])) break;
+      data[i] = std::move(data[best]);
+      i = best;
+    }
+    data[i] = std::move(x);
+  }
+
+  vector<T> data;
+  Cmp cmp;
+};
+
+// Pairing heap, top() is the greatest by cmp. push and meld are O(1), pop is
+// O(log n) amortized with the two-pass pairing, and promote (decrease-key for a
+// min-heap) cuts the node's subtree and melds it with the root.
+template <typename T, typename Cmp = std::less<T>>
+class PairingHeap {
+  struct Node {
+    T value;
+    Node *child{nullptr}, *next{nullptr}, *prev{nullptr};  // prev: parent or left
+  };
+
+ public:
+  using handle = Node *;
+
+  explicit PairingHeap(Cmp cmp = {}) : cmp(cmp) {}
+  PairingHeap(const PairingHeap &) = delete;
+  PairingHeap &operator=(const PairingHeap &) = delete;
+  PairingHeap(PairingHeap &&o) noexcept
+      : root(std::exchange(o.root, nullptr)), count(std::exchange(o.count, 0)),
+        cmp(o.cmp) {}
+  ~PairingHeap() { clear(); }
+
+  const T &top() const { return root->value; }
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  handle push(T x) {
+    auto *n = new Node{std::move(x)};
+    root = link(root, n);
+    ++count;
+    return n;
+  }
+
+  void pop() {
+    auto *old = root;
+    root = pair_children(old->child);
+    if (root) root->prev = nullptr;
+    delete old;
+    --count;
+  }
+
+  // raise the priority of h to x; x must not compare lower than the current value
+  void promote(handle h, T x) {
+    h->value = std::move(x);
+    if (h == root) return;
+    detach(h);
+    root = link(root, h);
+  }
+
+  // move every element of o into this heap in O(1)
+  void meld(PairingHeap &o) {
+    root = link(root, std::exchange(o.root, nullptr));
+    count += std::exchange(o.count, 0);
+  }
+
+  void clear() {
+    vector<Node *> stack;
+    if (root) stack.push_back(root);
+    while (!stack.empty()) {
+      auto *n = stack.back();
+      stack.pop_back();
+      if (n->child) stack.push_back(n->child);
+      if (n->next) stack.push_back(n->next);
+      delete n;
+    }
+    root = nullptr;
+    count = 0;
+  }
+
+ private:
+  // make the lower of a, b the leftmost child of the other
+  Node *link(Node *a, Node *b) {
+    if (!a) return b;
+    if (!b) return a;
+    if (cmp(a->value, b->value)) std::swap(a, b);
+    b->next = a->child;
+    if (a->child) a->child->prev = b;
+    b->prev = a;
+    a->child = b;
+    a->next = nullptr;
+    return a;
+  }
+
+  void detach(Node *h) {
+    if (h->prev->child == h)
+      h->prev->child = h->next;
+    else
+      h->prev->next = h->next;
+    if (h->next) h->next->prev = h->prev;
+    h->next = h->prev = nullptr;
+  }
+
+  // two-pass pairing: link siblings left to right in pairs, then fold right to left
+  Node *pair_children(Node *first) {
+    pairs.clear();
+    while (first) {
+      auto *a = first, *b = first->next;
+      first = b ? b->next : nullptr;
+      a->next = a->prev = nullptr;
+      if (b) b->next = b->prev = nullptr;
+      pairs.push_back(link(a, b));
+    }
+    Node *r = nullptr;
+    for (auto *p : pairs | V::reverse) r = link(p, r);
+    return r;
+  }
+
+  Node *root{nullptr};
+  size_t count{0};
+  Cmp cmp;
+  vector<Node *> pairs;
+};
+
+int main() {
+  /************************************************************************************/
+  // 01_heaps.cpp
+  {
+    vector h = {1, 6, 1, 8, 0, 3};
+
+    DaryHeap<int, 4> d4;
+    d4.push_range(h);
+    d4.push(9);
+    vector<int> out;
+    while (!d4.empty()) {
+      out.push_back(d4.top());
+      d4.pop();
+    }
+    print("Ex01: 4-ary heap pops: {}\n", out);
+
+    // min-heap through a custom comparator
+    DaryHeap<int, 8, std::greater<>> d8;
+    d8.push_range(h);
+    print("Ex01: 8-ary min-heap top: {}\n", d8.top());
+
+    PairingHeap<int, std::greater<>> timers;
+    vector<PairingHeap<int, std::greater<>>::handle> hs;
+    for (auto x : h) hs.push_back(timers.push(x * 10));
+    timers.promote(hs[3], 5);  // 80 -> 5
+    PairingHeap<int, std::greater<>> more;
+    more.push(7);
+    more.push(2);
+    timers.meld(more);
+    out.clear();
+    while (!timers.empty()) {
+      out.push_back(timers.top());
+      timers.pop();
+    }
+    print("Ex01: pairing min-heap after promote and meld: {}\n", out);
+  }
+
+  /************************************************************************************/
+  // 02_bench_heaps.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    // timer wheel style workload: a standing queue of N deadlines, each step pops
+    // the earliest and pushes a new deadline a random delay after it
+    const size_t N = 1'000'000, OPS = 4'000'000;
+    std::mt19937_64 gen{2112};
+    vector<uint64_t> initial(N), delays(OPS);
+    R::generate(initial, [&] { return gen() % 1'000'000'000; });
+    R::generate(delays, [&] { return gen() % 1'000'000; });
+    using Later = std::greater<uint64_t>;
+
+    auto run = [&](const char *name, auto &&q, auto push, auto top, auto pop) {
+      auto start = clock::now();
+      for (auto x : initial) push(q, x);
+      duration<double> t_fill = clock::now() - start;
+      start = clock::now();
+      uint64_t check = 0;
+      for (auto d : delays) {
+        const auto t = top(q);
+        check += t;
+        pop(q);
+        push(q, t + d);
+      }
+      duration<double> t_mix = clock::now() - start;
+      print("Ex02: {:24} fill {:.4f}s pop/push {:.4f}s check {}\n", name,
+            t_fill.count(), t_mix.count(), check);
+    };
+
+    auto push = [](auto &q, auto x) { q.push(x); };
+    auto top = [](auto &q) { return q.top(); };
+    auto pop = [](auto &q) { q.pop(); };
+
+    run("std::priority_queue", std::priority_queue<uint64_t, vector<uint64_t>, Later>{},
+        push, top, pop);
+    run(
+        "R::push_heap/pop_heap", vector<uint64_t>{},
+        [](auto &v, auto x) {
+          v.push_back(x);
+          R::push_heap(v, Later{});
+        },
+        [](auto &v) { return v.front(); },
+        [](auto &v) {
+          R::pop_heap(v, Later{});
+          v.pop_back();
+        });
+    run("DaryHeap<2>", DaryHeap<uint64_t, 2, Later>{}, push, top, pop);
+    run("DaryHeap<4>", DaryHeap<uint64_t, 4, Later>{}, push, top, pop);
+    run("DaryHeap<8>", DaryHeap<uint64_t, 8, Later>{}, push, top, pop);
+    run("PairingHeap", PairingHeap<uint64_t, Later>{}, push, top, pop);
+
+    // batch insert into a half full heap
+    auto batch = [&](const char *name, auto fill) {
+      DaryHeap<uint64_t, 4, Later> q;
+      q.push_range(initial | V::take(N / 2));
+      auto start = clock::now();
+      fill(q);
+      duration<double> elapsed = clock::now() - start;
+      print("Ex02: {:24} {:.4f}s top {}\n", name, elapsed.count(), q.top());
+    };
+    auto second_half = initial | V::drop(N / 2);
+    batch("push x N/2", [&](auto &q) {
+      for (auto x : second_half) q.push(x);
+    });
+    batch("push_range(N/2)", [&](auto &q) { q.push_range(second_half); });
+  }
+}
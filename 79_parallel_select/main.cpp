@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <vector>
+
+using std::vector, std::print;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// run fn(t, begin, end) over n_threads contiguous chunks of [0, n)
+template <typename Fn>
+void parallel_chunks(size_t n, unsigned n_threads, Fn fn) {
+  if (n_threads <= 1) return fn(0u, size_t{0}, n);
+  vector<std::jthread> pool;
+  for (unsigned t = 0; t < n_threads; ++t)
+    pool.emplace_back(fn, t, n * t / n_threads, n * (t + 1) / n_threads);
+}
+
+// Stable parallel partition: every thread counts its chunk, prefix sums give each
+// chunk disjoint slots in the true and false halves, every thread scatters its
+// chunk into a buffer, and the buffer is moved back in parallel. Returns the index
+// of the first element for which pred is false.
+template <typename T, typename Pred>
+size_t par_partition(std::span<T> data, Pred pred, unsigned n_threads) {
+  const auto n = data.size();
+  n_threads = static_cast<unsigned>(std::clamp<size_t>(n / 65536, 1, n_threads));
+  if (n_threads == 1)
+    return std::stable_partition(data.begin(), data.end(), pred) - data.begin();
+
+  vector<size_t> trues(n_threads + 1), falses(n_threads + 1);
+  parallel_chunks(n, n_threads, [&](unsigned t, size_t b, size_t e) {
+    auto c = std::count_if(data.begin() + b, data.begin() + e, pred);
+    trues[t + 1] = static_cast<size_t>(c);
+    falses[t + 1] = (e - b) - trues[t + 1];
+  });
+  std::partial_sum(trues.begin(), trues.end(), trues.begin());
+  std::partial_sum(falses.begin(), falses.end(), falses.begin());
+  const auto split = trues.back();
+
+  vector<T> buffer(n);
+  parallel_chunks(n, n_threads, [&](unsigned t, size_t b, size_t e) {
+    auto ti = trues[t], fi = split + falses[t];
+    for (auto i = b; i < e; ++i)
+      buffer[pred(data[i]) ? ti++ : fi++] = std::move(data[i]);
+  });
+  parallel_chunks(n, n_threads, [&](unsigned, size_t b, size_t e) {
+    std::move(buffer.begin() + b, buffer.begin() + e, data.begin() + b);
+  });
+  return split;
+}
+
+// Parallel nth_element by quickselect: pick the pivot as the median of a sample,
+// split into < pivot | == pivot | > pivot with two parallel partitions and keep only
+// the side that holds k. Below a cutoff std::nth_element finishes the job.
+template <typename T, typename Cmp = std::less<>>
+void par_nth_element(std::span<T> data, size_t k, unsigned n_threads, Cmp cmp = {}) {
+  std::mt19937 gen{static_cast<unsigned>(data.size())};
+  while (data.size() > 262'144 && n_threads > 1) {
+    vector<T> sample(63);
+    for (auto &s : sample) s = data[gen() % data.size()];
+    R::nth_element(sample, sample.begin() + 31, cmp);
+    const T pivot = sample[31];
+
+    auto lo = par_partition(data, [&](const T &x) { return cmp(x, pivot); }, n_threads);
+    if (k < lo) {
+      data = data.first(lo);
+      continue;
+    }
+    auto rest = data.subspan(lo);
+    auto not_gt = [&](const T &x) { return !cmp(pivot, x); };
+    auto eq = par_partition(rest, not_gt, n_threads);
+    if (k < lo + eq) return;
+    data = rest.subspan(eq);
+    k -= lo + eq;
+  }
+  std::nth_element(data.begin(), data.begin() + k, data.end(), cmp);
+}
+
+// Bounded heap keeping the k greatest elements seen (by cmp). The heap is a min-heap
+// on cmp, so the smallest of the kept elements is at the front and a new element
+// only costs a compare unless it beats it.
+template <typename T, typename Cmp = std::less<>>
+class TopK {
+ public:
+  explicit TopK(size_t k, Cmp cmp = {}) : k(k), cmp(cmp) { heap.reserve(k); }
+
+  void push(const T &x) {
+    if (k == 0) return;
+    if (heap.size() < k) {
+      heap.push_back(x);
+      R::push_heap(heap, greater());
+    } else if (cmp(heap.front(), x)) {
+      R::pop_heap(heap, greater());
+      heap.back() = x;
+      R::push_heap(heap, greater());
+    }
+  }
+
+  void merge(const TopK &o) {
+    for (const auto &x : o.heap) push(x);
+  }
+
+  // greatest first
+  vector<T> sorted() const {
+    auto out = heap;
+    R::sort(out, [this](const T &a, const T &b) { return cmp(b, a); });
+    return out;
+  }
+
+ private:
+  auto greater() const {
+    return [this](const T &a, const T &b) { return cmp(b, a); };
+  }
+
+  size_t k;
+  Cmp cmp;
+  vector<T> heap;
+};
+
+// one bounded heap per thread over its chunk, then merge the heaps
+template <typename T, typename Cmp = std::less<>>
+vector<T> par_top_k(std::span<const T> data, size_t k, unsigned n_threads,
+                    Cmp cmp = {}) {
+  const auto n = data.size();
+  n_threads = static_cast<unsigned>(std::clamp<size_t>(n / 65536, 1, n_threads));
+  vector<TopK<T, Cmp>> heaps(n_threads, TopK<T, Cmp>(k, cmp));
+  parallel_chunks(n, n_threads, [&](unsigned t, size_t b, size_t e) {
+    for (auto i = b; i < e; ++i) heaps[t].push(data[i]);
+  });
+  for (size_t t = 1; t < heaps.size(); ++t) heaps[0].merge(heaps[t]);
+  return heaps[0].sorted();
+}
+
+int main() {
+  /************************************************************************************/
+  // 01_parallel_select.cpp
+  {
+    vector v{7, 12341, 3, 13, 9, 242341, 8, 2, 6};
+    print("Ex01: original: {}\n", v);
+
+    auto is_even = [](auto n) { return n % 2 == 0; };
+    auto tail = par_partition(std::span(v), is_even, 4);
+    print("Ex01: part 0: {} rest: {}\n", V::take(v, tail), V::drop(v, tail));
+
+    par_nth_element(std::span(v), v.size() / 2, 4);
+    print("Ex01: median: {}\n", v[v.size() / 2]);
+
+    TopK<int> top3(3);
+    for (auto x : v) top3.push(x);
+    print("Ex01: top 3: {}\n", top3.sorted());
+  }
+
+  /************************************************************************************/
+  // 02_bench_parallel_select.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const auto hw = std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937_64 gen{2112};
+
+    for (size_t N : {1'000'000uz, 10'000'000uz}) {
+      vector<uint64_t> base(N);
+      R::generate(base, gen);
+      const auto mid = N / 2;
+      const size_t K = 100;
+      auto v = base;
+
+      auto time = [&](auto fn) {
+        v = base;
+        auto start = clock::now();
+        fn();
+        duration<double> elapsed = clock::now() - start;
+        return elapsed.count();
+      };
+
+      auto odd = [](auto x) { return x & 1; };
+      auto t_part = time([&] { std::partition(v.begin(), v.end(), odd); });
+      auto t_nth = time([&] { std::nth_element(v.begin(), v.begin() + mid, v.end()); });
+      const auto median = v[mid];
+      vector<uint64_t> expected_top;
+      auto t_psort = time([&] {
+        std::partial_sort(v.begin(), v.begin() + K, v.end(), std::greater<>());
+        expected_top.assign(v.begin(), v.begin() + K);
+      });
+      print("Ex02: N={:>10} std partition {:.4f}s nth_element {:.4f}s ", N, t_part,
+            t_nth);
+      print("partial_sort(top {}) {:.4f}s\n", K, t_psort);
+
+      for (unsigned t : {1u, 2u, 4u, hw}) {
+        auto p_part = time([&] { par_partition(std::span(v), odd, t); });
+        auto p_nth = time([&] { par_nth_element(std::span(v), mid, t); });
+        const bool nth_ok = v[mid] == median;
+        vector<uint64_t> top;
+        auto p_top = time([&] { top = par_top_k(std::span<const uint64_t>(v), K, t); });
+        print("Ex02:   threads {:2} par_partition {:.4f}s par_nth_element {:.4f}s ", t,
+              p_part, p_nth);
+        print("par_top_k {:.4f}s ok {}\n", p_top, nth_ok && top == expected_top);
+      }
+    }
+  }
+}
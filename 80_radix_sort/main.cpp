@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using std::vector, std::print, std::string, std::string_view;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// map a key to an unsigned integer of the same width whose unsigned order matches the
+// key order: flip the sign bit of signed ints; for IEEE floats flip every bit of
+// negatives and only the sign bit of positives
+template <typename K>
+auto radix_key(K k) {
+  if constexpr (std::unsigned_integral<K>) {
+    return k;
+  } else if constexpr (std::signed_integral<K>) {
+    using U = std::make_unsigned_t<K>;
+    return static_cast<U>(static_cast<U>(k) ^ (U{1} << (sizeof(K) * 8 - 1)));
+  } else {
+    static_assert(std::is_same_v<K, float> || std::is_same_v<K, double>);
+    using U = std::conditional_t<sizeof(K) == 4, uint32_t, uint64_t>;
+    const auto u = std::bit_cast<U>(k);
+    const U sign = U{1} << (sizeof(U) * 8 - 1);
+    return static_cast<U>(u & sign ? ~u : u | sign);
+  }
+}
+
+// LSD radix sort, 8 bits per pass, stable. key(x) may return any integer or float
+// type. Each pass splits the range into one chunk per thread: every thread counts
+// its chunk, the per-thread counts are prefix-summed into disjoint write offsets and
+// every thread scatters its chunk, so the parallel result is the sequential one.
+// Passes where all keys share the same digit are skipped. n_threads == 0 uses every
+// hardware thread.
+template <typename T, typename KeyFn = std::identity>
+void radix_sort_by(std::span<T> data, KeyFn key = {}, unsigned n_threads = 0) {
+  using U = decltype(radix_key(std::invoke(key, data[0])));
+  constexpr size_t passes = sizeof(U);
+  const auto n = data.size();
+  if (n < 2) return;
+
+  if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+  n_threads = static_cast<unsigned>(std::clamp<size_t>(n / 65536, 1, n_threads));
+  using Hist = std::array<size_t, 256>;
+  vector<Hist> hist(n_threads);
+  vector<size_t> bounds(n_threads + 1);
+  for (unsigned t = 0; t <= n_threads; ++t) bounds[t] = n * t / n_threads;
+
+  auto for_each_chunk = [&](auto fn) {
+    if (n_threads == 1) return fn(0u);
+    vector<std::jthread> pool;
+    for (unsigned t = 0; t < n_threads; ++t) pool.emplace_back(fn, t);
+  };
+
+  // digit histograms of every pass in one read, used to skip constant digits
+  vector<std::array<Hist, passes>> all(n_threads);
+  for_each_chunk([&](unsigned t) {
+    for (size_t i = bounds[t]; i < bounds[t + 1]; ++i) {
+      const U k = radix_key(std::invoke(key, data[i]));
+      for (size_t p = 0; p < passes; ++p) ++all[t][p][(k >> (8 * p)) & 0xff];
+    }
+  });
+
+  vector<T> buffer(n);
+  std::span<T> src = data, dst = buffer;
+  for (size_t p = 0; p < passes; ++p) {
+    size_t total_first = 0;
+    const auto first_digit = (radix_key(std::invoke(key, src[0])) >> (8 * p)) & 0xff;
+    for (const auto &h : all) total_first += h[p][first_digit];
+    if (total_first == n) continue;
+
+    const auto shift = 8 * p;
+    if (p > 0)
+      for_each_chunk([&](unsigned t) {
+        hist[t] = {};
+        for (size_t i = bounds[t]; i < bounds[t + 1]; ++i)
+          ++hist[t][(radix_key(std::invoke(key, src[i])) >> shift) & 0xff];
+      });
+    else
+      for (unsigned t = 0; t < n_threads; ++t) hist[t] = all[t][0];
+
+    size_t sum = 0;
+    for (size_t d = 0; d < 256; ++d)
+      for (unsigned t = 0; t < n_threads; ++t) sum += std::exchange(hist[t][d], sum);
+
+    for_each_chunk([&](unsigned t) {
+      auto &offs = hist[t];
+      for (size_t i = bounds[t]; i < bounds[t + 1]; ++i) {
+        const auto d = (radix_key(std::invoke(key, src[i])) >> shift) & 0xff;
+        dst[offs[d]++] = std::move(src[i]);
+      }
+    });
+    std::swap(src, dst);
+  }
+  if (src.data() != data.data()) R::move(src, data.begin());
+}
+
+template <typename T>
+void radix_sort(std::span<T> data, unsigned n_threads = 0) {
+  radix_sort_by(data, std::identity{}, n_threads);
+}
+
+namespace detail {
+// byte of s at depth as a bucket 1..256, or 0 once s has ended
+inline size_t byte_at(const string &s, size_t depth) {
+  return depth < s.size() ? size_t(static_cast<unsigned char>(s[depth])) + 1 : 0;
+}
+
+// one in-place American flag pass: permute s by byte `depth`, return bucket starts
+inline std::array<size_t, 258> flag_partition(std::span<string> s, size_t depth) {
+  std::array<size_t, 258> start{};
+  for (const auto &x : s) ++start[byte_at(x, depth) + 1];
+  for (size_t b = 1; b < start.size(); ++b) start[b] += start[b - 1];
+
+  auto next = start;
+  for (size_t b = 0; b < 257; ++b) {
+    while (next[b] < start[b + 1]) {
+      auto d = byte_at(s[next[b]], depth);
+      if (d == b)
+        ++next[b];
+      else
+        std::swap(s[next[b]], s[next[d]++]);
+    }
+  }
+  return start;
+}
+
+inline void msd_sort(std::span<string> s, size_t depth) {
+  if (s.size() < 32) {
+    R::sort(s, [depth](const string &a, const string &b) {
+      return string_view(a).substr(std::min(depth, a.size())) <
+             string_view(b).substr(std::min(depth, b.size()));
+    });
+    return;
+  }
+  const auto start = flag_partition(s, depth);
+  for (size_t b = 1; b < 257; ++b)
+    if (start[b + 1] - start[b] > 1)
+      msd_sort(s.subspan(start[b], start[b + 1] - start[b]), depth + 1);
+}
+}  // namespace detail
+
+// MSD radix sort (American flag, in place) for strings. The parallel version does the
+// first pass on the calling thread and then hands out the 256 top-level buckets to
+// workers through an atomic counter, largest buckets first. n_threads == 0 uses every
+// hardware thread.
+inline void msd_radix_sort(std::span<string> s, unsigned n_threads = 0) {
+  if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+  if (n_threads <= 1 || s.size() < 65536) return detail::msd_sort(s, 0);
+
+  const auto start = detail::flag_partition(s, 0);
+  vector<size_t> order(V::iota(size_t{1}, size_t{257}) | R::to<vector>());
+  R::sort(order, R::greater{}, [&](auto b) { return start[b + 1] - start[b]; });
+
+  std::atomic<size_t> next{0};
+  vector<std::jthread> pool;
+  for (unsigned t = 0; t < n_threads; ++t)
+    pool.emplace_back([&] {
+      for (auto i = next++; i < order.size(); i = next++) {
+        const auto b = order[i];
+        detail::msd_sort(s.subspan(start[b], start[b + 1] - start[b]), 1);
+      }
+    });
+}
+
+int main() {
+  /************************************************************************************/
+  // 01_radix_sort.cpp
+  {
+    vector<int> ints = {3, -1, 4, -1, 5, 9, -2, 6, 5, 3, 5, -2112};
+    radix_sort(std::span(ints));
+    print("Ex01: ints: {}\n", ints);
+
+    vector<double> reals = {2.5, -0.0, 0.0, -3.75, 1e300, -1e-300, 42.0, -42.0};
+    radix_sort(std::span(reals));
+    print("Ex01: doubles: {}\n", reals);
+
+    vector<string> names = {"Regan", "Lisa", "Corbin", "John", "Li", "", "Lisandra"};
+    msd_radix_sort(names);
+    print("Ex01: strings: {}\n", names);
+
+    struct Person {
+      string name;
+      int age{0};
+    };
+    vector<Person> people = {{"Regan", 30}, {"Lisa", 40}, {"Corbin", 45}, {"John", 30}};
+    radix_sort_by(std::span(people), &Person::age);
+    auto p_str = [](auto &p) { return std::format("{} {}", p.name, p.age); };
+    print("Ex01: by age (stable): {}\n", people | V::transform(p_str));
+  }
+
+  /************************************************************************************/
+  // 02_bench_radix_sort.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const size_t N = 2'000'000;
+    const auto hw = std::max(1u, std::thread::hardware_concurrency());
+    std::mt19937_64 gen{2112};
+
+    auto bench = [&](const char *name, auto base, auto radix) {
+      auto v = base;
+      auto start = clock::now();
+      std::sort(v.begin(), v.end());
+      duration<double> t_sort = clock::now() - start;
+      const auto expected = v;
+
+      v = base;
+      start = clock::now();
+      std::stable_sort(v.begin(), v.end());
+      duration<double> t_stable = clock::now() - start;
+
+      v = base;
+      start = clock::now();
+      radix(v, 1u);
+      duration<double> t_radix = clock::now() - start;
+      bool ok = v == expected;
+
+      v = base;
+      start = clock::now();
+      radix(v, hw);
+      duration<double> t_par = clock::now() - start;
+      ok = ok && v == expected;
+
+      print("Ex02: {:8} sort {:.4f}s stable_sort {:.4f}s radix {:.4f}s", name,
+            t_sort.count(), t_stable.count(), t_radix.count());
+      print(" par({}) {:.4f}s ok {}\n", hw, t_par.count(), ok);
+    };
+
+    auto numeric = [](auto &v, unsigned t) { radix_sort(std::span(v), t); };
+
+    vector<uint32_t> u32(N);
+    R::generate(u32, [&] { return uint32_t(gen()); });
+    bench("uint32", u32, numeric);
+
+    vector<int64_t> i64(N);
+    R::generate(i64, [&] { return int64_t(gen()); });
+    bench("int64", i64, numeric);
+
+    std::normal_distribution<float> nd{0.0f, 1000.0f};
+    vector<float> f32(N);
+    R::generate(f32, [&] { return nd(gen); });
+    bench("float", f32, numeric);
+
+    vector<string> strs(N / 2);
+    for (auto &s : strs) {
+      s.resize(4 + gen() % 12);
+      for (auto &c : s) c = char('a' + gen() % 26);
+    }
+    bench("string", strs, [](auto &v, unsigned t) { msd_radix_sort(v, t); });
+  }
+}
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using std::vector, std::print, std::string, std::string_view;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+enum class SortMode { unstable, stable };
+
+// Normalized key prefix: leading sort keys packed into three big-endian words so that
+// comparing the words compares the keys. A string takes two words (15 bytes and
+// min(size, 16) in the low byte), an integer one word with its sign bit flipped.
+// `exact` says every key was packed in full, so equal words mean equal keys.
+struct KeyPrefix {
+  std::array<uint64_t, 3> w{};
+  bool exact{true};
+
+  template <typename K>
+  bool push(size_t &used, const K &k) {
+    if constexpr (std::is_convertible_v<const K &, string_view>) {
+      if (used + 2 > w.size()) return exact = false;
+      string_view s = k;
+      std::array<unsigned char, 16> bytes{};
+      std::memcpy(bytes.data(), s.data(), std::min<size_t>(s.size(), 15));
+      bytes[15] = static_cast<unsigned char>(std::min<size_t>(s.size(), 16));
+      for (size_t i = 0; i < 16; ++i) w[used + i / 8] = w[used + i / 8] << 8 | bytes[i];
+      used += 2;
+      return exact = s.size() < 16;
+    } else {
+      static_assert(std::integral<K>, "KeyPrefix: string or integer keys");
+      if (used + 1 > w.size()) return exact = false;
+      if constexpr (std::signed_integral<K>)
+        w[used++] = uint64_t(int64_t(k)) ^ (uint64_t{1} << 63);
+      else
+        w[used++] = uint64_t(k);
+      return true;
+    }
+  }
+};
+
+// Sorts row indices instead of rows. Each entry carries a normalized prefix of the
+// keys, so most comparisons are a few integer compares; the full multi-key compare on
+// the rows only runs when prefixes tie and were not exact. Stable mode breaks the
+// final tie on the row index, which makes the order total, so chunks can be sorted
+// with std::sort and merged in parallel without changing the result.
+template <typename T, typename... Keys>
+vector<uint32_t> sort_index(std::span<const T> rows, SortMode mode, unsigned n_threads,
+                            Keys... keys) {
+  static_assert(sizeof...(Keys) > 0, "sort_index: at least one key");
+  struct Entry {
+    KeyPrefix key;
+    uint32_t idx;
+  };
+
+  const auto n = rows.size();
+  vector<Entry> a(n), b(n);
+  for (size_t i = 0; i < n; ++i) {
+    size_t used = 0;
+    (void)(a[i].key.push(used, std::invoke(keys, rows[i])) && ...);
+    a[i].idx = static_cast<uint32_t>(i);
+  }
+
+  auto less = [&, mode](const Entry &x, const Entry &y) {
+    for (size_t i = 0; i < x.key.w.size(); ++i)
+      if (x.key.w[i] != y.key.w[i]) return x.key.w[i] < y.key.w[i];
+    if (!x.key.exact) {
+      const T &l = rows[x.idx], &r = rows[y.idx];
+      int c = 0;
+      auto step = [&](const auto &key) {
+        const auto &kl = std::invoke(key, l);
+        const auto &kr = std::invoke(key, r);
+        c = kl < kr ? -1 : kr < kl ? 1 : 0;
+        return c != 0;
+      };
+      if ((step(keys) || ...)) return c < 0;
+    }
+    return mode == SortMode::stable && x.idx < y.idx;
+  };
+
+  if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+  n_threads = static_cast<unsigned>(std::clamp<size_t>(n / 4096, 1, n_threads));
+
+  // chunk boundaries, sort chunks, then merge neighbours pairwise, ping-ponging a/b
+  vector<size_t> bounds(n_threads + 1);
+  for (unsigned t = 0; t <= n_threads; ++t) bounds[t] = n * t / n_threads;
+  {
+    vector<std::jthread> pool;
+    for (unsigned t = 0; t < n_threads; ++t)
+      pool.emplace_back([&, t] {
+        std::sort(a.begin() + bounds[t], a.begin() + bounds[t + 1], less);
+      });
+  }
+  for (size_t width = 1; width < n_threads; width *= 2) {
+    vector<std::jthread> pool;
+    for (size_t t = 0; t < n_threads; t += 2 * width) {
+      const auto lo = bounds[t];
+      const auto mid = bounds[std::min<size_t>(t + width, n_threads)];
+      const auto hi = bounds[std::min<size_t>(t + 2 * width, n_threads)];
+      pool.emplace_back([&, lo, mid, hi] {
+        std::merge(a.begin() + lo, a.begin() + mid, a.begin() + mid, a.begin() + hi,
+                   b.begin() + lo, less);
+      });
+    }
+    pool.clear();
+    std::swap(a, b);
+  }
+
+  vector<uint32_t> order(n);
+  R::transform(a, order.begin(), &Entry::idx);
+  return order;
+}
+
+// gather rows in index order, moving each row exactly once
+template <typename T>
+vector<T> apply_order(vector<T> &&rows, const vector<uint32_t> &order) {
+  vector<T> out;
+  out.reserve(rows.size());
+  for (auto i : order) out.push_back(std::move(rows[i]));
+  return out;
+}
+
+struct Person {
+  std::string name;
+  int age{0};
+  Person(std::string n, int a) : name(n), age(a) {}
+};
+
+int main() {
+  /************************************************************************************/
+  // 01_multikey_sort.cpp
+  {
+    std::vector<Person> people = {
+        Person("Regan", 30), Person("Lisa", 40), Person("Corbin", 45),
+        Person("John", 99),  Person("Lisa", 21), Person("Corbin", 12),
+    };
+
+    auto p_str = [](const Person &p) { return std::format("{} {}", p.name, p.age); };
+    std::span<const Person> rows(people);
+
+    auto by_name_age =
+        sort_index(rows, SortMode::stable, 0, &Person::name, &Person::age);
+    print("Ex01: By Name, Age: {}\n",
+          by_name_age | V::transform([&](auto i) { return p_str(people[i]); }));
+
+    auto by_age = sort_index(rows, SortMode::unstable, 0, &Person::age);
+    print("Ex01: By Age: {}\n",
+          by_age | V::transform([&](auto i) { return p_str(people[i]); }));
+
+    people = apply_order(std::move(people), by_name_age);
+    print("Ex01: gathered: {}\n", people | V::transform(p_str));
+  }
+
+  /************************************************************************************/
+  // 02_bench_multikey_sort.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const size_t N = 2'000'000;
+    std::mt19937 gen{2112};
+    vector<string> first_names(2'000);
+    for (auto &s : first_names) {
+      s.resize(5 + gen() % 8);
+      for (auto &c : s) c = char('a' + gen() % 26);
+    }
+
+    vector<Person> base;
+    base.reserve(N);
+    for (size_t i = 0; i < N; ++i)
+      base.emplace_back(first_names[gen() % first_names.size()], int(gen() % 100));
+
+    auto name_age = [](const Person &a, const Person &b) {
+      return a.name != b.name ? a.name < b.name : a.age < b.age;
+    };
+
+    auto people = base;
+    auto start = clock::now();
+    R::sort(people, name_age);
+    duration<double> elapsed = clock::now() - start;
+    print("Ex02: R::sort        (name, age)     {:.4f}s\n", elapsed.count());
+
+    people = base;
+    start = clock::now();
+    R::stable_sort(people, name_age);
+    elapsed = clock::now() - start;
+    print("Ex02: R::stable_sort (name, age)     {:.4f}s\n", elapsed.count());
+    const auto expected = people;
+    auto key = [](const Person &p) { return std::tie(p.name, p.age); };
+
+    for (unsigned threads : {1u, 2u, 4u, std::thread::hardware_concurrency()}) {
+      for (auto mode : {SortMode::unstable, SortMode::stable}) {
+        people = base;
+        start = clock::now();
+        auto order = sort_index(std::span<const Person>(people), mode, threads,
+                                &Person::name, &Person::age);
+        duration<double> index_time = clock::now() - start;
+        people = apply_order(std::move(people), order);
+        elapsed = clock::now() - start;
+
+        const bool ok = mode == SortMode::stable
+                            ? R::equal(people, expected, {}, key, key)
+                            : R::is_sorted(people, name_age);
+        print("Ex02: sort_index {:8} t={:2} index {:.4f}s +gather {:.4f}s ok {}\n",
+              mode == SortMode::stable ? "stable" : "unstable", threads,
+              index_time.count(), elapsed.count(), ok);
+      }
+    }
+  }
+}
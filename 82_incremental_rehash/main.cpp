@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <forward_list>
+#include <functional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using std::vector, std::print, std::string;
+
+// Chained hash map that never rehashes all at once: on growth the old bucket array is
+// kept alongside the new one and every operation migrates a few old buckets, so the
+// cost of a resize is spread over the following operations instead of one spike.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class IncrementalHashMap {
+ public:
+  explicit IncrementalHashMap(size_t capacity = 16, size_t migrate_step = 8)
+      : table(std::bit_ceil(std::max<size_t>(capacity, 2))),
+        step(std::max<size_t>(migrate_step, 1)) {}
+
+  bool get(const Key &key, Value &value) {
+    migrate();
+    if (auto *v = find(key)) {
+      value = *v;
+      return true;
+    }
+    return false;
+  }
+
+  Value *find(const Key &key) {
+    const auto h = hasher(key);
+    if (rehashing()) {
+      const auto ob = h & (old.size() - 1);
+      if (ob >= moved)
+        for (auto &node : old[ob])
+          if (node.key == key) return &node.value;
+    }
+    for (auto &node : table[h & (table.size() - 1)])
+      if (node.key == key) return &node.value;
+    return nullptr;
+  }
+
+  void put(const Key &key, const Value &value) {
+    migrate();
+    if (auto *v = find(key)) {
+      *v = value;
+      return;
+    }
+    if (!rehashing() && count + 1 > table.size()) grow();
+    table[hasher(key) & (table.size() - 1)].emplace_front(key, value);
+    ++count;
+  }
+
+  bool remove(const Key &key) {
+    migrate();
+    const auto h = hasher(key);
+    auto pred = [&](const Node &node) { return node.key == key; };
+    size_t n = 0;
+    if (rehashing() && (h & (old.size() - 1)) >= moved)
+      n += old[h & (old.size() - 1)].remove_if(pred);
+    n += table[h & (table.size() - 1)].remove_if(pred);
+    count -= n;
+    return n != 0;
+  }
+
+  size_t size() const { return count; }
+  size_t bucket_count() const { return table.size(); }
+  bool rehashing() const { return !old.empty(); }
+
+ private:
+  struct Node {
+    Key key;
+    Value value;
+    Node(const Key &k, const Value &v) : key(k), value(v) {}
+  };
+  using Bucket = std::forward_list<Node>;
+
+  void grow() {
+    old = std::move(table);
+    table = vector<Bucket>(old.size() * 2);
+    moved = 0;
+  }
+
+  // relink the nodes of up to `step` old buckets into the new table, no allocation
+  void migrate() {
+    if (!rehashing()) return;
+    const auto stop = std::min(old.size(), moved + step);
+    for (; moved < stop; ++moved) {
+      auto &src = old[moved];
+      while (!src.empty()) {
+        auto &dst = table[hasher(src.front().key) & (table.size() - 1)];
+        dst.splice_after(dst.before_begin(), src, src.before_begin());
+      }
+    }
+    if (moved == old.size()) {
+      old = {};
+      moved = 0;
+    }
+  }
+
+  vector<Bucket> table, old;
+  size_t moved{0}, count{0}, step;
+  Hash hasher;
+};
+
+// 94_ch_06 ChainedHashTable, made generic over key/value
+template <typename Key, typename Value>
+class ChainedHashTable {
+ public:
+  ChainedHashTable(size_t capacity) : capacity(capacity) { table.resize(capacity); }
+
+  bool get(const Key &key, Value &value) const {
+    const auto &list = table[hash(key)];
+    for (const auto &bucket : list) {
+      if (bucket.key == key) {
+        value = bucket.value;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void put(const Key &key, const Value &value) {
+    auto &list = table[hash(key)];
+    for (auto &bucket : list) {
+      if (bucket.key == key) {
+        bucket.value = value;
+        return;
+      }
+    }
+    list.emplace_front(key, value);
+  }
+
+ private:
+  struct Bucket {
+    Key key;
+    Value value;
+    Bucket(Key k, Value v) : key(k), value(v) {}
+  };
+
+  std::vector<std::forward_list<Bucket>> table;
+  size_t capacity;
+  size_t hash(const Key &key) const { return std::hash<Key>{}(key) % capacity; }
+};
+
+// log2-binned per-operation latency histogram
+struct LatencyHistogram {
+  std::array<uint64_t, 64> bins{};
+  uint64_t n{0}, max_ns{0};
+
+  void record(uint64_t ns) {
+    ++bins[std::bit_width(ns)];
+    ++n;
+    max_ns = std::max(max_ns, ns);
+  }
+
+  // upper bound (ns) of the bin holding the p-th quantile
+  uint64_t percentile(double p) const {
+    auto want = static_cast<uint64_t>(p * double(n));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bins.size(); ++i)
+      if ((seen += bins[i]) > want) return i == 0 ? 0 : (uint64_t{1} << i) - 1;
+    return max_ns;
+  }
+};
+
+int main() {
+  /************************************************************************************/
+  // 01_incremental_rehash.cpp
+  {
+    IncrementalHashMap<string, int> ages(4, 1);
+
+    for (auto [name, age] : {std::pair{"Lisa", 28}, {"Corbin", 25}, {"Aaron", 30},
+                             {"Regan", 22}, {"Amanda", 35}}) {
+      ages.put(name, age);
+      print("Ex01: put {:6} size {} buckets {} rehashing {}\n", name, ages.size(),
+            ages.bucket_count(), ages.rehashing());
+    }
+
+    int value;
+    if (ages.get("Corbin", value)) print("Ex01: Corbin's age: {}\n", value);
+    if (!ages.get("Daisy", value)) print("Ex01: Daisy not found in the map.\n");
+
+    ages.put("Lisa", 29);
+    ages.remove("Aaron");
+    if (ages.get("Lisa", value)) print("Ex01: Lisa's updated age: {}\n", value);
+    print("Ex01: size {} buckets {} rehashing {}\n", ages.size(), ages.bucket_count(),
+          ages.rehashing());
+  }
+
+  /************************************************************************************/
+  // 02_bench_growth_latency.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration, std::chrono::nanoseconds;
+
+    const size_t N = 4'000'000;
+    vector<uint64_t> keys(N);
+    std::mt19937_64 gen{2112};
+    std::ranges::generate(keys, gen);
+
+    auto run = [&](const char *name, auto &map, auto insert) {
+      LatencyHistogram hist;
+      const auto start = clock::now();
+      for (auto k : keys) {
+        const auto t0 = clock::now();
+        insert(map, k);
+        hist.record(std::chrono::duration_cast<nanoseconds>(clock::now() - t0).count());
+      }
+      duration<double> elapsed = clock::now() - start;
+      print("Ex02: {:20} total {:.3f}s p50 {}ns p99 {}ns p99.9 {}ns max {}ns\n", name,
+            elapsed.count(), hist.percentile(0.5), hist.percentile(0.99),
+            hist.percentile(0.999), hist.max_ns);
+    };
+
+    std::unordered_map<uint64_t, uint64_t> um;
+    run("std::unordered_map", um, [](auto &m, auto k) { m[k] = k; });
+
+    IncrementalHashMap<uint64_t, uint64_t> im;
+    run("IncrementalHashMap", im, [](auto &m, auto k) { m.put(k, k); });
+
+    // fixed capacity: never rehashes, so it is sized for the final load up front
+    ChainedHashTable<uint64_t, uint64_t> ch(N);
+    run("ChainedHashTable(N)", ch, [](auto &m, auto k) { m.put(k, k); });
+
+    uint64_t v = 0, hits = 0;
+    for (auto k : keys | std::views::take(1000)) hits += im.get(k, v) && v == k;
+    print("Ex02: IncrementalHashMap lookups ok {}\n", hits == 1000);
+  }
+}
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <print>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using std::vector, std::print, std::string, std::string_view;
+namespace R = std::ranges;
+namespace V = std::ranges::views;
+
+// hash for string keys that also accepts string_view / const char* lookups
+struct StringHash {
+  using is_transparent = void;
+  size_t operator()(string_view s) const { return std::hash<string_view>{}(s); }
+};
+
+template <typename Key>
+using default_hash_t =
+    std::conditional_t<std::is_same_v<Key, string>, StringHash, std::hash<Key>>;
+
+template <typename Key>
+using default_eq_t = std::conditional_t<std::is_same_v<Key, string>,
+                                        std::equal_to<>, std::equal_to<Key>>;
+
+// unordered_multiset replacement: every distinct key is stored once with its count,
+// so count() is a single lookup instead of a walk over every duplicate node.
+template <typename Key, typename Hash = default_hash_t<Key>,
+          typename Eq = default_eq_t<Key>>
+class CountingMultiset {
+ public:
+  using map_type = std::unordered_map<Key, size_t, Hash, Eq>;
+  using value_type = std::pair<Key, size_t>;
+
+  CountingMultiset() = default;
+  explicit CountingMultiset(size_t bucket_hint) { counts.reserve(bucket_hint); }
+
+  // add n copies of key, returns the new count
+  template <typename K>
+  size_t insert(K &&key, size_t n = 1) {
+    auto it = counts.find(key);
+    if (it == counts.end()) it = counts.emplace(std::forward<K>(key), 0).first;
+    total += n;
+    return it->second += n;
+  }
+
+  // remove up to n copies of key, returns the new count
+  template <typename K>
+  size_t erase_one(const K &key, size_t n = 1) {
+    auto it = counts.find(key);
+    if (it == counts.end()) return 0;
+    if (it->second <= n) {
+      total -= it->second;
+      counts.erase(it);
+      return 0;
+    }
+    total -= n;
+    return it->second -= n;
+  }
+
+  // remove every copy of key, returns how many were removed
+  template <typename K>
+  size_t erase(const K &key) {
+    auto it = counts.find(key);
+    if (it == counts.end()) return 0;
+    auto n = it->second;
+    total -= n;
+    counts.erase(it);
+    return n;
+  }
+
+  template <typename K>
+  size_t count(const K &key) const {
+    auto it = counts.find(key);
+    return it == counts.end() ? 0 : it->second;
+  }
+
+  template <typename K>
+  bool contains(const K &key) const {
+    return counts.find(key) != counts.end();
+  }
+
+  size_t size() const { return total; }
+  size_t unique_size() const { return counts.size(); }
+  bool empty() const { return total == 0; }
+  void clear() {
+    counts.clear();
+    total = 0;
+  }
+
+  // k most frequent keys, highest count first (ties by key for stable output)
+  vector<value_type> top_k(size_t k) const {
+    vector<std::pair<const Key *, size_t>> refs;
+    refs.reserve(counts.size());
+    for (const auto &[key, n] : counts) refs.emplace_back(&key, n);
+
+    k = std::min(k, refs.size());
+    auto heavier = [](const auto &a, const auto &b) {
+      return a.second != b.second ? a.second > b.second : *a.first < *b.first;
+    };
+    R::partial_sort(refs, refs.begin() + k, heavier);
+
+    vector<value_type> out;
+    out.reserve(k);
+    for (const auto &[key, n] : refs | V::take(k)) out.emplace_back(*key, n);
+    return out;
+  }
+
+  // fold the counts of o into this one
+  void merge(const CountingMultiset &o) {
+    counts.reserve(counts.size() + o.counts.size());
+    for (const auto &[key, n] : o.counts) insert(key, n);
+  }
+
+  void merge(CountingMultiset &&o) {
+    if (counts.size() < o.counts.size()) std::swap(*this, o);
+    counts.reserve(counts.size() + o.counts.size());
+    while (!o.counts.empty()) {
+      auto node = o.counts.extract(o.counts.begin());
+      auto it = counts.find(node.key());
+      if (it == counts.end())
+        counts.insert(std::move(node));
+      else
+        it->second += node.mapped();
+    }
+    total += o.total;
+    o.total = 0;
+  }
+
+  // per-thread tables over disjoint chunks of data, then a pairwise merge tree
+  template <typename T>
+  static CountingMultiset build_parallel(std::span<const T> data,
+                                         unsigned n_threads = 0) {
+    if (n_threads == 0) n_threads = std::max(1u, std::thread::hardware_concurrency());
+    n_threads = static_cast<unsigned>(std::clamp<size_t>(data.size(), 1, n_threads));
+
+    vector<CountingMultiset> parts(n_threads);
+    {
+      vector<std::jthread> pool;
+      pool.reserve(n_threads);
+      const auto chunk = (data.size() + n_threads - 1) / n_threads;
+      for (unsigned t = 0; t < n_threads; ++t) {
+        pool.emplace_back([&, t] {
+          auto b = std::min(data.size(), t * chunk);
+          auto e = std::min(data.size(), b + chunk);
+          for (const auto &x : data.subspan(b, e - b)) parts[t].insert(x);
+        });
+      }
+    }
+
+    for (size_t step = 1; step < parts.size(); step *= 2) {
+      vector<std::jthread> pool;
+      for (size_t i = 0; i + step < parts.size(); i += 2 * step)
+        pool.emplace_back([&, i, step] { parts[i].merge(std::move(parts[i + step])); });
+    }
+    return parts.empty() ? CountingMultiset{} : std::move(parts.front());
+  }
+
+  auto begin() const { return counts.begin(); }
+  auto end() const { return counts.end(); }
+
+ private:
+  map_type counts;
+  size_t total{0};
+};
+
+// words drawn from a vocabulary with Zipf(s) rank frequencies
+vector<string> zipf_words(size_t n, size_t vocab, double s, unsigned seed) {
+  vector<double> cdf(vocab);
+  double acc = 0;
+  for (size_t r = 0; r < vocab; ++r) cdf[r] = acc += 1.0 / std::pow(double(r + 1), s);
+  for (auto &c : cdf) c /= acc;
+
+  std::mt19937_64 gen{seed};
+  std::uniform_real_distribution<double> u{0.0, 1.0};
+  vector<string> out;
+  out.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    auto r = R::lower_bound(cdf, u(gen)) - cdf.begin();
+    out.push_back("word" + std::to_string(std::min<size_t>(r, vocab - 1)));
+  }
+  return out;
+}
+
+int main() {
+  /************************************************************************************/
+  // 01_counting_multiset.cpp
+  {
+    CountingMultiset<string> fruits;
+
+    for (auto f : {"apple", "banana", "apple", "orange", "apple", "mango", "banana"})
+      fruits.insert(f);
+
+    print("Ex01: Number of apples: {}\n", fruits.count("apple"));
+    print("Ex01: size {} unique {}\n", fruits.size(), fruits.unique_size());
+    print("Ex01: top 2 {}\n", fruits.top_k(2));
+
+    fruits.erase_one("apple");
+    print("Ex01: apples after erase_one: {}\n", fruits.count(string_view("apple")));
+
+    fruits.erase("apple");
+    print("Ex01: apples after erase: {}\n", fruits.count("apple"));
+
+    CountingMultiset<string> basket;
+    basket.insert("banana", 5);
+    basket.insert("kiwi");
+    fruits.merge(basket);
+    print("Ex01: merged top 3 {}\n", fruits.top_k(3));
+  }
+
+  /************************************************************************************/
+  // 02_bench_zipf.cpp
+  {
+    using clock = std::chrono::high_resolution_clock;
+    using std::chrono::duration;
+
+    const size_t N = 2'000'000;
+    const size_t vocab = 50'000;
+    auto words = zipf_words(N, vocab, 1.1, 2112);
+    const vector<string> probes = {"word0", "word1", "word10", "word1000", "nope"};
+
+    auto start = clock::now();
+    std::unordered_multiset<string> ums(words.begin(), words.end());
+    duration<double> elapsed = clock::now() - start;
+    print("Ex02: unordered_multiset build  {:.4f}s\n", elapsed.count());
+
+    start = clock::now();
+    size_t ums_hits = 0;
+    for (const auto &p : probes) ums_hits += ums.count(p);
+    elapsed = clock::now() - start;
+    print("Ex02: unordered_multiset count  {:.6f}s hits {}\n", elapsed.count(),
+          ums_hits);
+
+    start = clock::now();
+    CountingMultiset<string> cms(vocab);
+    for (const auto &w : words) cms.insert(w);
+    elapsed = clock::now() - start;
+    print("Ex02: CountingMultiset build    {:.4f}s\n", elapsed.count());
+
+    start = clock::now();
+    size_t cms_hits = 0;
+    for (const auto &p : probes) cms_hits += cms.count(p);
+    elapsed = clock::now() - start;
+    print("Ex02: CountingMultiset count    {:.6f}s hits {}\n", elapsed.count(),
+          cms_hits);
+
+    start = clock::now();
+    using CMS = CountingMultiset<string>;
+    auto pcms = CMS::build_parallel(std::span<const string>(words));
+    elapsed = clock::now() - start;
+    print("Ex02: CountingMultiset par build {:.4f}s same {}\n", elapsed.count(),
+          pcms.size() == cms.size() && pcms.top_k(10) == cms.top_k(10));
+
+    start = clock::now();
+    auto heavy = cms.top_k(5);
+    elapsed = clock::now() - start;
+    print("Ex02: top 5 {:.6f}s {}\n", elapsed.count(), heavy);
+  }
+}